@@ -0,0 +1,145 @@
+#include "AssetPack.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ASSETPACK_MMAP 1
+#endif
+
+static_assert(sizeof(AssetPack::Header) == 16, "Pack header layout changed");
+static_assert(sizeof(AssetPack::Entry) == 56, "Pack entry layout changed");
+
+std::uint64_t AssetPack::idForPath(const std::filesystem::path& assetPath) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char c : assetPath.lexically_normal().generic_string()) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+AssetPack::~AssetPack() {
+    close();
+}
+
+bool AssetPack::open(const std::filesystem::path& packPath) {
+    close();
+
+#ifdef ASSETPACK_MMAP
+    int fd = ::open(packPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file alive on its own
+    ::close(fd);
+    if (mapping == MAP_FAILED) return false;
+
+    data = static_cast<const std::uint8_t*>(mapping);
+    size = static_cast<std::size_t>(status.st_size);
+    mapped = true;
+#else
+    std::ifstream file(packPath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+
+    fileContents.resize(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    if (fileContents.empty() || !file.read(reinterpret_cast<char*>(fileContents.data()), fileContents.size())) {
+        fileContents.clear();
+        return false;
+    }
+
+    data = fileContents.data();
+    size = fileContents.size();
+#endif
+
+    path = packPath;
+    if (size < sizeof(Header)) {
+        close();
+        return false;
+    }
+
+    entries = reinterpret_cast<const Entry*>(data + sizeof(Header));
+    entryCount = reinterpret_cast<const Header*>(data)->entryCount;
+
+    if (!validate()) {
+        close();
+        return false;
+    }
+
+    sourceStates = std::make_unique<std::atomic<std::uint8_t>[]>(entryCount);
+    for (std::size_t i = 0; i < entryCount; ++i) {
+        sourceStates[i].store(UNCHECKED, std::memory_order_relaxed);
+    }
+
+    return true;
+}
+
+void AssetPack::close() {
+#ifdef ASSETPACK_MMAP
+    if (mapped) {
+        munmap(const_cast<std::uint8_t*>(data), size);
+    }
+#endif
+
+    fileContents.clear();
+    fileContents.shrink_to_fit();
+    data = nullptr;
+    size = 0;
+    mapped = false;
+    entries = nullptr;
+    entryCount = 0;
+    sourceStates.reset();
+    path.clear();
+}
+
+bool AssetPack::validate() const {
+    const Header& header = *reinterpret_cast<const Header*>(data);
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) return false;
+    if (entryCount > (size - sizeof(Header)) / sizeof(Entry)) return false;
+
+    for (std::size_t i = 0; i < entryCount; ++i) {
+        const Entry& entry = entries[i];
+        if (entry.offset > size || entry.size > size - entry.offset) return false;
+        if (i > 0 && entries[i - 1].id >= entry.id) return false;
+    }
+
+    return true;
+}
+
+const AssetPack::Entry* AssetPack::find(const std::filesystem::path& assetPath) const {
+    if (!isOpen()) return nullptr;
+
+    std::uint64_t id = idForPath(assetPath);
+    const Entry* end = entries + entryCount;
+    const Entry* entry = std::lower_bound(entries, end, id, [](const Entry& candidate, std::uint64_t value) {
+        return candidate.id < value;
+    });
+
+    if (entry == end || entry->id != id) return nullptr;
+
+    std::atomic<std::uint8_t>& state = sourceStates[entry - entries];
+    if (state.load(std::memory_order_relaxed) == UNCHECKED) {
+        // Without a loose copy the pack is all there is; with one, it must be the file that was packed
+        bool current = true;
+        std::error_code error;
+        std::uintmax_t fileSize = std::filesystem::file_size(assetPath, error);
+        if (!error) {
+            std::filesystem::file_time_type modified = std::filesystem::last_write_time(assetPath, error);
+            current = !error && fileSize == entry->sourceSize && modified.time_since_epoch().count() == entry->sourceModified;
+        }
+        state.store(current ? CURRENT : STALE, std::memory_order_relaxed);
+    }
+
+    return state.load(std::memory_order_relaxed) == CURRENT ? entry : nullptr;
+}
@@ -0,0 +1,93 @@
+#ifndef ASSETPACK_H
+#define ASSETPACK_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// A read-only archive of pre-decoded assets built by the packer target:
+// a header, an index sorted by asset ID, then 16-byte aligned payloads.
+// Opened with mmap where available, so only the pages an asset touches are
+// ever read; elsewhere the whole file is read in once. Multi-byte fields
+// are in host byte order, as the pack is built on the machine it ships for.
+class AssetPack {
+public:
+    enum class Type : std::uint32_t {
+        RAW,    // the file's bytes, e.g. a font
+        IMAGE,  // RGBA8 rows; info = width, height
+        SOUND   // 16 channel map bytes, then 16-bit PCM; info = channel count, sample rate
+    };
+
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t entryCount;
+    };
+
+    struct Entry {
+        std::uint64_t id;
+        Type type;
+        std::uint32_t info[2];
+        std::uint32_t reserved;
+        std::uint64_t offset;  // from the start of the file
+        std::uint64_t size;
+        std::uint64_t sourceSize;     // of the file the asset was packed from
+        std::int64_t sourceModified;  // its last write time, in std::filesystem::file_time_type ticks
+    };
+
+    static constexpr char MAGIC[8] = {'P', 'A', 'C', 'M', 'P', 'A', 'C', 'K'};
+    static constexpr std::uint32_t VERSION = 2;
+    static constexpr std::size_t PAYLOAD_ALIGNMENT = 16;
+    static constexpr std::size_t MAX_SOUND_CHANNELS = 16;
+
+    // FNV-1a of the path in normal generic form, e.g. "assets/sounds/credit.wav"
+    static std::uint64_t idForPath(const std::filesystem::path& assetPath);
+
+    AssetPack() = default;
+    ~AssetPack();
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    // False if the file is missing or not a valid pack; a pack already open is closed first
+    bool open(const std::filesystem::path& packPath);
+
+    void close();
+
+    bool isOpen() const { return data != nullptr; }
+
+    const std::filesystem::path& getPath() const { return path; }
+
+    // nullptr if the pack holds no asset for assetPath, or if a file at assetPath
+    // differs in size or write time from the one packed, e.g. after an edit the
+    // pack has not been rebuilt for; the caller then loads that file instead.
+    // The file is only looked at on the asset's first lookup since open().
+    const Entry* find(const std::filesystem::path& assetPath) const;
+
+    // The entry's payload; valid until the pack is closed
+    const std::uint8_t* getPayload(const Entry& entry) const { return data + entry.offset; }
+
+private:
+    // Checks the header and that every payload lies inside the file
+    bool validate() const;
+
+    std::filesystem::path path;
+    const std::uint8_t* data = nullptr;
+    std::size_t size = 0;
+
+    bool mapped = false;
+    std::vector<std::uint8_t> fileContents;  // without mmap
+
+    const Entry* entries = nullptr;
+    std::size_t entryCount = 0;
+
+    // Per entry, what its first lookup found: one of the SourceState values
+    enum SourceState : std::uint8_t { UNCHECKED, CURRENT, STALE };
+    mutable std::unique_ptr<std::atomic<std::uint8_t>[]> sourceStates;
+};
+
+#endif
@@ -0,0 +1,177 @@
+// Build-time tool: decodes the game's assets once and writes them to a single
+// AssetPack, so the game maps one file instead of opening and decoding each.
+//
+//     packer <output.pack> <root directory> <asset path>...
+//
+// Asset paths are relative to the root and become the IDs the game asks for,
+// e.g. "assets/sounds/credit.wav". Nothing here needs a window or GL context,
+// so the pack builds on display-less hosts.
+
+#include "AssetPack.h"
+#include <SFML/Audio/SoundBuffer.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct PackedAsset {
+    std::string name;
+    AssetPack::Entry entry{};
+    std::vector<std::uint8_t> payload;
+};
+
+template <typename T>
+void appendBytes(std::vector<std::uint8_t>& payload, const T* values, std::size_t count) {
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(values);
+    payload.insert(payload.end(), bytes, bytes + count * sizeof(T));
+}
+
+std::string lowercaseExtension(const std::filesystem::path& path) {
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+    return extension;
+}
+
+// Decodes images and sounds; anything else is stored as it is
+PackedAsset packAsset(const std::filesystem::path& root, const std::string& name) {
+    const std::filesystem::path sourcePath = root / name;
+    const std::string extension = lowercaseExtension(sourcePath);
+
+    PackedAsset asset;
+    asset.name = std::filesystem::path(name).lexically_normal().generic_string();
+    asset.entry.id = AssetPack::idForPath(name);
+    // Lets the game tell when the file has changed since and load it instead
+    asset.entry.sourceSize = std::filesystem::file_size(sourcePath);
+    asset.entry.sourceModified = static_cast<std::int64_t>(std::filesystem::last_write_time(sourcePath).time_since_epoch().count());
+
+    if (extension == ".png" || extension == ".bmp" || extension == ".jpg" || extension == ".tga") {
+        sf::Image image;
+        if (!image.loadFromFile(sourcePath)) {
+            throw std::runtime_error("Could not decode image: " + sourcePath.string());
+        }
+
+        asset.entry.type = AssetPack::Type::IMAGE;
+        asset.entry.info[0] = image.getSize().x;
+        asset.entry.info[1] = image.getSize().y;
+        appendBytes(asset.payload, image.getPixelsPtr(), static_cast<std::size_t>(image.getSize().x) * image.getSize().y * 4);
+    } else if (extension == ".wav" || extension == ".ogg" || extension == ".flac" || extension == ".mp3") {
+        sf::SoundBuffer buffer;
+        if (!buffer.loadFromFile(sourcePath)) {
+            throw std::runtime_error("Could not decode sound: " + sourcePath.string());
+        }
+
+        std::vector<sf::SoundChannel> channelMap = buffer.getChannelMap();
+        if (channelMap.size() != buffer.getChannelCount() || channelMap.size() > AssetPack::MAX_SOUND_CHANNELS) {
+            throw std::runtime_error("Unsupported channel layout: " + sourcePath.string());
+        }
+
+        asset.entry.type = AssetPack::Type::SOUND;
+        asset.entry.info[0] = buffer.getChannelCount();
+        asset.entry.info[1] = buffer.getSampleRate();
+        asset.payload.resize(AssetPack::MAX_SOUND_CHANNELS, 0);
+        for (std::size_t i = 0; i < channelMap.size(); ++i) {
+            asset.payload[i] = static_cast<std::uint8_t>(channelMap[i]);
+        }
+        appendBytes(asset.payload, buffer.getSamples(), static_cast<std::size_t>(buffer.getSampleCount()));
+    } else {
+        std::ifstream file(sourcePath, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open asset: " + sourcePath.string());
+        }
+
+        asset.entry.type = AssetPack::Type::RAW;
+        asset.payload.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    asset.entry.size = asset.payload.size();
+    return asset;
+}
+
+// Writes to a temporary file first, so a failed run never leaves a truncated pack
+void writePack(const std::filesystem::path& outputPath, std::vector<PackedAsset>& assets) {
+    std::sort(assets.begin(), assets.end(), [](const PackedAsset& a, const PackedAsset& b) { return a.entry.id < b.entry.id; });
+
+    for (std::size_t i = 1; i < assets.size(); ++i) {
+        if (assets[i - 1].entry.id == assets[i].entry.id) {
+            throw std::runtime_error("Asset IDs collide: " + assets[i - 1].name + " and " + assets[i].name);
+        }
+    }
+
+    const auto align = [](std::uint64_t offset) {
+        return (offset + AssetPack::PAYLOAD_ALIGNMENT - 1) / AssetPack::PAYLOAD_ALIGNMENT * AssetPack::PAYLOAD_ALIGNMENT;
+    };
+
+    std::uint64_t offset = align(sizeof(AssetPack::Header) + assets.size() * sizeof(AssetPack::Entry));
+    for (PackedAsset& asset : assets) {
+        asset.entry.offset = offset;
+        offset = align(offset + asset.entry.size);
+    }
+
+    AssetPack::Header header{};
+    std::memcpy(header.magic, AssetPack::MAGIC, sizeof(header.magic));
+    header.version = AssetPack::VERSION;
+    header.entryCount = static_cast<std::uint32_t>(assets.size());
+
+    std::filesystem::path temporaryPath = outputPath;
+    temporaryPath += ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not write " + temporaryPath.string());
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const PackedAsset& asset : assets) {
+            file.write(reinterpret_cast<const char*>(&asset.entry), sizeof(asset.entry));
+        }
+
+        const char padding[AssetPack::PAYLOAD_ALIGNMENT] = {};
+        for (const PackedAsset& asset : assets) {
+            file.write(padding, static_cast<std::streamsize>(asset.entry.offset - static_cast<std::uint64_t>(file.tellp())));
+            file.write(reinterpret_cast<const char*>(asset.payload.data()), static_cast<std::streamsize>(asset.payload.size()));
+        }
+
+        if (!file) {
+            throw std::runtime_error("Could not write " + temporaryPath.string());
+        }
+    }
+
+    std::filesystem::rename(temporaryPath, outputPath);
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " <output.pack> <root directory> <asset path>..." << std::endl;
+        return 1;
+    }
+
+    try {
+        const std::filesystem::path outputPath = argv[1];
+        const std::filesystem::path root = argv[2];
+
+        std::vector<PackedAsset> assets;
+        for (int i = 3; i < argc; ++i) {
+            assets.push_back(packAsset(root, argv[i]));
+        }
+
+        writePack(outputPath, assets);
+        std::cout << "Packed " << assets.size() << " assets into " << outputPath.string() << " ("
+                  << std::filesystem::file_size(outputPath) << " bytes)" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
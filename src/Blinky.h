@@ -2,13 +2,21 @@
 #define BLINKY_H
 
 #include "Ghost.h"
+#include "MazeMap.h"
 #include <SFML/System/Vector2.hpp>
 
-class Blinky : public Ghost {
-public:
-    void setTargetTile(sf::Vector2i target);
+// Red: chases Pac-Man's own tile and scatters to the top-right corner
+struct Blinky {
+    static constexpr Ghost::AIType type = Ghost::AIType::BLINKY;
+    static constexpr bool followsPacmanField = true;
 
-    void setBestMove(Entity& pacman);
+    static sf::Vector2i chaseTarget(const MazeMap&, sf::Vector2i pacmanTile, MovementDir) {
+        return pacmanTile;
+    }
+
+    static sf::Vector2i scatterTarget(const MazeMap& map) {
+        return {static_cast<int>(map.getWidth()) - 1, 0};
+    }
 };
 
 #endif
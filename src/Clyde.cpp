@@ -1,5 +0,0 @@
-#include "Clyde.h"
-
-void Clyde::setTargetTile(Entity& pacman) {
-
-};
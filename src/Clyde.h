@@ -2,10 +2,21 @@
 #define CLYDE_H
 
 #include "Ghost.h"
+#include "MazeMap.h"
+#include <SFML/System/Vector2.hpp>
 
-class Clyde : public Ghost {
-public:
-    void setTargetTile(Entity& pacman);
+// Orange: chases Pac-Man's own tile and scatters to the bottom-left corner
+struct Clyde {
+    static constexpr Ghost::AIType type = Ghost::AIType::CLYDE;
+    static constexpr bool followsPacmanField = true;
+
+    static sf::Vector2i chaseTarget(const MazeMap&, sf::Vector2i pacmanTile, MovementDir) {
+        return pacmanTile;
+    }
+
+    static sf::Vector2i scatterTarget(const MazeMap& map) {
+        return {0, static_cast<int>(map.getHeight()) - 1};
+    }
 };
 
 #endif
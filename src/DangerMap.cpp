@@ -0,0 +1,106 @@
+#include "DangerMap.h"
+#include "Entity.h"
+#include "MazeMap.h"
+#include <algorithm>
+
+namespace {
+    // Heading order: up, down, left, right. Index ^ 1 is the reverse direction.
+    int headingIndex(MovementDir dir) {
+        switch (dir) {
+            case MovementDir::UP: return 0;
+            case MovementDir::DOWN: return 1;
+            case MovementDir::LEFT: return 2;
+            case MovementDir::RIGHT: return 3;
+            default: return 4;
+        }
+    }
+}
+
+void DangerMap::compute(const MazeMap& map, std::vector<Source>& sources) {
+    width = static_cast<int>(map.getWidth());
+    height = static_cast<int>(map.getHeight());
+
+    std::size_t tileCount = static_cast<std::size_t>(width) * height;
+    tileArrival.assign(tileCount, NEVER);
+    if (tileCount == 0) return;
+
+    // One search per distinct speed; each is a plain BFS with staggered start times
+    std::sort(sources.begin(), sources.end(), [](const Source& a, const Source& b) {
+        return a.ticksPerTile != b.ticksPerTile ? a.ticksPerTile < b.ticksPerTile : a.delayTicks < b.delayTicks;
+    });
+
+    for (std::size_t first = 0; first < sources.size();) {
+        std::size_t last = first;
+        while (last < sources.size() && sources[last].ticksPerTile == sources[first].ticksPerTile) {
+            ++last;
+        }
+
+        searchFrom(map, sources, first, last);
+        first = last;
+    }
+}
+
+void DangerMap::searchFrom(const MazeMap& map, const std::vector<Source>& sources, std::size_t first, std::size_t last) {
+    const unsigned int ticksPerTile = std::max(1u, sources[first].ticksPerTile);
+
+    stateArrival.assign(tileArrival.size() * 4, NEVER);
+    queue.clear();
+
+    auto isOpen = [&](int tile) { return !map.isWall({tile % width, tile / width}); };
+
+    // Arrival ticks leave the queue in order, so a seed joins as soon as the
+    // queue front is no earlier than its delay
+    std::size_t nextSource = first;
+    std::size_t head = 0;
+
+    while (head < queue.size() || nextSource < last) {
+        Step step;
+        if (nextSource < last && (head == queue.size() || sources[nextSource].delayTicks <= queue[head].tick)) {
+            const Source& source = sources[nextSource++];
+            if (source.tile.y < 0 || source.tile.y >= height) continue;
+
+            int x = ((source.tile.x % width) + width) % width;
+            step = {x + source.tile.y * width, headingIndex(source.heading), source.delayTicks};
+            if (!isOpen(step.tile)) continue;
+
+            if (step.heading != ANY_HEADING) {
+                unsigned int& known = stateArrival[step.tile * 4 + step.heading];
+                if (known <= step.tick) continue;
+                known = step.tick;
+            }
+        } else {
+            step = queue[head++];
+            if (step.heading != ANY_HEADING && stateArrival[step.tile * 4 + step.heading] < step.tick) continue;
+        }
+
+        tileArrival[step.tile] = std::min(tileArrival[step.tile], step.tick);
+
+        int x = step.tile % width;
+        int y = step.tile / width;
+        const int neighbours[4] = {
+            y > 0 ? step.tile - width : -1,
+            y < height - 1 ? step.tile + width : -1,
+            x > 0 ? step.tile - 1 : step.tile + width - 1,  // tunnels wrap horizontally
+            x < width - 1 ? step.tile + 1 : step.tile - width + 1
+        };
+
+        unsigned int nextTick = step.tick + ticksPerTile;
+        for (int heading = 0; heading < 4; ++heading) {
+            int neighbour = neighbours[heading];
+            if (neighbour < 0 || (step.heading != ANY_HEADING && heading == (step.heading ^ 1)) || !isOpen(neighbour)) continue;
+
+            unsigned int& known = stateArrival[neighbour * 4 + heading];
+            if (known <= nextTick) continue;
+
+            known = nextTick;
+            queue.push_back({neighbour, heading, nextTick});
+        }
+    }
+}
+
+unsigned int DangerMap::arrivalTick(sf::Vector2i tile) const {
+    if (width == 0 || tile.y < 0 || tile.y >= height) return NEVER;
+
+    tile.x = ((tile.x % width) + width) % width;
+    return tileArrival[tile.x + tile.y * width];
+}
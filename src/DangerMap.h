@@ -0,0 +1,54 @@
+#ifndef DANGERMAP_H
+#define DANGERMAP_H
+
+#include <SFML/System/Vector2.hpp>
+#include <limits>
+#include <vector>
+
+class MazeMap;
+enum class MovementDir;
+
+// Earliest tick, counted from now, at which any dangerous ghost can stand on
+// each maze tile. Ghosts never reverse, so the search runs over (tile, heading)
+// states rather than tiles. Lookups are O(1); compute() is O(tiles) per ghost speed.
+// A scalar BFS on purpose: a bitboard flood (a 64-bit word per maze row, one
+// shift per heading per wavefront) gave the same maps but took about twice as
+// long on a 28x31 maze, whose few sparse wavefronts leave most bits idle.
+class DangerMap {
+public:
+    static constexpr unsigned int NEVER = std::numeric_limits<unsigned int>::max();
+
+    struct Source {
+        sf::Vector2i tile;
+        MovementDir heading;      // STATIC: may leave in any direction
+        unsigned int ticksPerTile;
+        unsigned int delayTicks;  // e.g. until an unreleased ghost may move
+    };
+
+    // Reorders sources by speed and delay
+    void compute(const MazeMap& map, std::vector<Source>& sources);
+
+    // NEVER for walls, tiles off the maze and tiles no ghost can reach. x wraps like the tunnels.
+    unsigned int arrivalTick(sf::Vector2i tile) const;
+
+private:
+    struct Step {
+        int tile;
+        int heading;  // index into the direction tables, or ANY_HEADING
+        unsigned int tick;
+    };
+
+    static constexpr int ANY_HEADING = 4;
+
+    // Multi-source BFS for ghosts sharing one speed; sources sorted by delay
+    void searchFrom(const MazeMap& map, const std::vector<Source>& sources, std::size_t first, std::size_t last);
+
+    int width = 0;
+    int height = 0;
+
+    std::vector<unsigned int> tileArrival;
+    std::vector<unsigned int> stateArrival;  // tile * 4 + heading
+    std::vector<Step> queue;
+};
+
+#endif
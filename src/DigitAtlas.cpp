@@ -0,0 +1,16 @@
+#include "DigitAtlas.h"
+#include <stdexcept>
+
+DigitAtlas::DigitAtlas(const sf::Image& strip, bool withTexture) : image(strip) {
+    if (image.getSize().x < 10 || image.getSize().x % 10 != 0 || image.getSize().y == 0) {
+        throw std::runtime_error("A digit strip must be ten equal cells wide");
+    }
+    cellSize = {static_cast<float>(image.getSize().x / 10), static_cast<float>(image.getSize().y)};
+
+    if (withTexture) {
+        if (!texture.loadFromImage(image)) {
+            throw std::runtime_error("Could not upload the digit strip");
+        }
+        texture.setSmooth(false);
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef DIGITATLAS_H
+#define DIGITATLAS_H
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/System/Vector2.hpp>
+
+// The glyphs '0'-'9' of a font as a strip image of ten equal-width cells, so
+// numbers can be drawn as quads without sf::Text relayout. The strip is kept
+// as an image as well, which a SoftwareRenderer can draw from.
+class DigitAtlas {
+public:
+    // The texture is only uploaded withTexture, so scenes drawn without a GPU
+    // can use the strip too
+    DigitAtlas(const sf::Image& strip, bool withTexture);
+
+    const sf::Texture& getTexture() const { return texture; }
+
+    const sf::Image& getImage() const { return image; }
+
+    sf::Vector2f getCellSize() const { return cellSize; }
+
+    // Texture rect of a digit's cell
+    sf::FloatRect getDigitRect(int digit) const {
+        return {{digit * cellSize.x, 0.0f}, cellSize};
+    }
+
+private:
+    sf::Image image;
+    sf::Texture texture;
+    sf::Vector2f cellSize;
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "Entity.h"
+#include "OccupancyGrid.h"
 #include <SFML/Graphics/PrimitiveType.hpp>
 #include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/RenderStates.hpp>
@@ -26,11 +27,20 @@ void Entity::setAnimationTiles(sf::Texture& textureSheet,
         entityAnimation.sprites.push_back(sprite);
     }
 
-    animations.push_back(entityAnimation);
+    if (!animations) {
+        animations = std::make_shared<std::vector<EntityAnimation>>();
+    } else if (animations.use_count() > 1) {
+        animations = std::make_shared<std::vector<EntityAnimation>>(*animations);
+        activeSprite = nullptr;
+    }
+
+    animations->push_back(entityAnimation);
 };
 
 void Entity::setActiveSprite(const std::string& animationName, int animationTile) {
-    for (auto& animation : animations) {
+    if (!animations) return;
+
+    for (const auto& animation : *animations) {
          if (animation.name == animationName) {
             activeSprite = &animation.sprites.at(animationTile);
             return;
@@ -38,7 +48,20 @@ void Entity::setActiveSprite(const std::string& animationName, int animationTile
     }
 };
 
+sf::Vector2f Entity::getInterpolationOffset() const {
+    sf::Vector2f jump = previousPosition - getPosition();
+
+    // A jump larger than the sprite is a teleport (tunnel wrap, respawn), not
+    // motion; judged before scaling, which would shrink it late in the frame
+    if (std::abs(jump.x) >= tileSize.x || std::abs(jump.y) >= tileSize.y) {
+        return {0.0f, 0.0f};
+    }
+
+    return jump * (1.0f - interpolationAlpha);
+}
+
 void Entity::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    states.transform.translate(getInterpolationOffset());
     states.transform *= getTransform();
     if (activeSprite) {
         target.draw(*activeSprite, states);
@@ -51,7 +74,28 @@ void Entity::startMove(MovementDir dir, sf::Vector2f target) {
     isMoving = true;
 }
 
-void Entity::update() {
+void Entity::teleport(sf::Vector2f position) {
+    setPosition(position);
+    previousPosition = position;
+    currentDirection = MovementDir::STATIC;
+    targetPosition = std::nullopt;
+    isMoving = false;
+}
+
+void Entity::setOccupancyGrid(OccupancyGrid* grid, unsigned int slot) {
+    occupancyGrid = grid;
+    occupancySlot = slot;
+}
+
+void Entity::updateOccupiedTile(sf::Vector2i tile) {
+    currentMazeTile = tile;
+
+    if (occupancyGrid) {
+        occupancyGrid->place(occupancySlot, tile);
+    }
+}
+
+void Entity::update(float arrivalTolerance) {
     if (!isMoving || !targetPosition.has_value()) {
         return;
     }
@@ -62,7 +106,7 @@ void Entity::update() {
     sf::Vector2f direction = target - currentPos;
     float distance = std::sqrt(direction.x * direction.x + direction.y * direction.y);
 
-    if (distance < 1.0f) {
+    if (distance < arrivalTolerance) {
         setPosition(target);
         isMoving = false;
         targetPosition = std::nullopt;
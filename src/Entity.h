@@ -12,11 +12,13 @@
 #include <SFML/Graphics/VertexArray.hpp>
 #include <SFML/System/Vector2.hpp>
 #include <filesystem>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
 class MazeMap;
+class OccupancyGrid;
 
 enum class MovementDir {
     STATIC,
@@ -33,22 +35,28 @@ struct EntityAnimation {
 
 class Entity : public sf::Transformable, public sf::Drawable {
 public:
-    Entity() : movementSpeed({5.0f, 5.0f}),
+    Entity() : activeSprite(nullptr),
+               movementSpeed({5.0f, 5.0f}),
                currentDirection(MovementDir::STATIC),
                queuedDirection(MovementDir::STATIC),
                targetPosition(std::nullopt),
                isMoving(false),
-               mazeMap(nullptr) {};
+               interpolationAlpha(1.0f),
+               mazeMap(nullptr),
+               occupancyGrid(nullptr),
+               occupancySlot(0) {};
 
     void setAnimationTiles(sf::Texture& textureSheet, sf::Vector2i pixelLocation, const std::string& animationName, sf::Vector2i tileSize, unsigned int animationTiles, unsigned int pixelGap);
 
-    sf::Sprite* getActiveSprite() { return activeSprite; };
+    const sf::Sprite* getActiveSprite() const { return activeSprite; };
 
     void setActiveSprite(const std::string& animationName, int animationTile);
 
     void startMove(MovementDir dir, sf::Vector2f target);
 
-    void update();
+    // Steps towards the move's target, snapping onto it and stopping once
+    // within arrivalTolerance pixels
+    void update(float arrivalTolerance);
 
     void queueDirection(MovementDir dir) { queuedDirection = dir; }
 
@@ -76,6 +84,26 @@ public:
         }
     }
 
+    // Remembers the current position as where this tick's motion starts
+    void storePreviousPosition() { previousPosition = getPosition(); }
+
+    sf::Vector2f getPreviousPosition() const { return previousPosition; }
+
+    // 0 draws at the previous tick position, 1 at the current one
+    void setInterpolationAlpha(float alpha) { interpolationAlpha = alpha; }
+
+    // How far from its position draw() puts the entity this frame
+    sf::Vector2f getInterpolationOffset() const;
+
+    // Jumps to position, dropping any move in progress and the interpolation from the old spot
+    void teleport(sf::Vector2f position);
+
+    // Registers this entity as slot in grid; updateOccupiedTile() then keeps its entry current
+    void setOccupancyGrid(OccupancyGrid* grid, unsigned int slot);
+
+    // Called after moving with the tile the entity is now in
+    void updateOccupiedTile(sf::Vector2i tile);
+
     void setMazeMap(MazeMap* map) { mazeMap = map; }
 
     MazeMap* getMazeMap() { return mazeMap; }
@@ -85,9 +113,11 @@ protected:
 
     sf::Vector2i tileSize;
 
-    std::vector<EntityAnimation> animations;
+    // Shared by copies of this entity, so many ghosts built from one template
+    // hold a single set of sprites; setAnimationTiles() copies on write
+    std::shared_ptr<std::vector<EntityAnimation>> animations;
 
-    sf::Sprite* activeSprite;
+    const sf::Sprite* activeSprite;
 
     sf::Vector2f movementSpeed;
 
@@ -101,7 +131,15 @@ protected:
 
     bool isMoving;
 
+    sf::Vector2f previousPosition;
+
+    float interpolationAlpha;
+
     MazeMap* mazeMap;
+
+    OccupancyGrid* occupancyGrid;
+
+    unsigned int occupancySlot;
 };
 
 #endif
@@ -0,0 +1,93 @@
+#include "FileWatcher.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+FileWatcher::FileWatcher(const std::vector<std::filesystem::path>& watchedFiles, ChangeHandler handler)
+    : onChange(std::move(handler)) {
+    for (const std::filesystem::path& file : watchedFiles) {
+        files.push_back(std::filesystem::absolute(file).lexically_normal());
+    }
+
+#ifdef __linux__
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0) {
+        throw std::runtime_error("Could not start inotify for hot-reload");
+    }
+
+    for (const std::filesystem::path& file : files) {
+        std::filesystem::path directory = file.parent_path();
+        bool alreadyWatched = std::any_of(watchedDirectories.begin(), watchedDirectories.end(),
+                                          [&](const auto& watched) { return watched.second == directory; });
+        if (alreadyWatched) continue;
+
+        int watch = inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (watch < 0) {
+            close(inotifyFd);
+            throw std::runtime_error("Could not watch for changes: " + directory.string());
+        }
+        watchedDirectories.push_back({watch, directory});
+    }
+
+    watchThread = std::thread(&FileWatcher::watchLoop, this);
+#else
+    std::cerr << "Hot-reload needs inotify and is not available on this platform" << std::endl;
+#endif
+}
+
+FileWatcher::~FileWatcher() {
+    stopping = true;
+    if (watchThread.joinable()) {
+        watchThread.join();
+    }
+
+#ifdef __linux__
+    if (inotifyFd >= 0) {
+        close(inotifyFd);
+    }
+#endif
+}
+
+void FileWatcher::watchLoop() {
+#ifdef __linux__
+    alignas(inotify_event) char buffer[4096];
+    pollfd descriptor{inotifyFd, POLLIN, 0};
+
+    while (!stopping) {
+        // Wake regularly so the destructor never waits long for the thread
+        if (poll(&descriptor, 1, 200) <= 0) continue;
+
+        ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) continue;
+
+        // One save often arrives as several events; report each file once per batch
+        std::vector<std::filesystem::path> changed;
+        for (ssize_t offset = 0; offset < length;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += sizeof(inotify_event) + event->len;
+            if (event->len == 0) continue;
+
+            auto directory = std::find_if(watchedDirectories.begin(), watchedDirectories.end(),
+                                          [&](const auto& watched) { return watched.first == event->wd; });
+            if (directory == watchedDirectories.end()) continue;
+
+            std::filesystem::path file = directory->second / event->name;
+            if (std::find(files.begin(), files.end(), file) != files.end() &&
+                std::find(changed.begin(), changed.end(), file) == changed.end()) {
+                changed.push_back(file);
+            }
+        }
+
+        for (const std::filesystem::path& file : changed) {
+            onChange(file);
+        }
+    }
+#endif
+}
@@ -0,0 +1,42 @@
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Calls onChange on a background thread whenever one of the watched files is
+// written or replaced. Uses inotify on Linux and watches each file's directory,
+// so editors that save by renaming a temporary file are seen too. Elsewhere it
+// reports that hot-reload is unavailable and never calls onChange.
+class FileWatcher {
+public:
+    using ChangeHandler = std::function<void(const std::filesystem::path& changedFile)>;
+
+    // Throws if inotify cannot be set up or a directory cannot be watched
+    FileWatcher(const std::vector<std::filesystem::path>& files, ChangeHandler onChange);
+
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    bool isActive() const { return watchThread.joinable(); }
+
+private:
+    void watchLoop();
+
+    std::vector<std::filesystem::path> files;  // absolute, as given otherwise
+    ChangeHandler onChange;
+
+    int inotifyFd = -1;
+    std::vector<std::pair<int, std::filesystem::path>> watchedDirectories;  // watch descriptor, directory
+
+    std::atomic<bool> stopping{false};
+    std::thread watchThread;
+};
+
+#endif
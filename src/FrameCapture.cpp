@@ -0,0 +1,79 @@
+#include "FrameCapture.h"
+#include "Game.h"
+#include "Replay.h"
+#include "SoftwareRenderer.h"
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <SFML/System/Clock.hpp>
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+void FrameCapture::run() {
+    Replay replay;
+    if (!settings.replayPath.empty() && !replay.loadFromFile(settings.replayPath)) {
+        throw std::runtime_error("Failed to load replay: " + settings.replayPath.string());
+    }
+
+    game.setHeadless(settings.softwareRenderer);
+    game.loadResources();
+    game.setupScene();
+
+    unsigned int workerCount = settings.workerCount;
+    if (workerCount == 0) {
+        workerCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Enough queued frames to ride out a slow disk without unbounded memory
+    const std::size_t maxQueuedFrames = workerCount * 8;
+    FrameEncoder encoder(settings.outputDir, settings.format, workerCount, maxQueuedFrames);
+
+    const sf::Vector2u frameSize = game.getBaseResolution();
+    std::vector<InputEvent> tickInput;
+    sf::Clock captureClock;
+
+    if (settings.softwareRenderer) {
+        SoftwareRenderer renderer(frameSize);
+        renderer.setAtlas(game.getAtlasImage());
+
+        for (unsigned long frame = 0; frame < settings.frameCount; ++frame) {
+            replay.inputForTick(game.getTickCount() + 1, tickInput);
+            game.tick(tickInput);
+
+            game.drawSceneSoftware(renderer);
+            encoder.submit(frame, renderer.toImage());
+        }
+    } else {
+        // copyToImage() is a synchronous readback: it waits for the frame to
+        // finish rendering. Only the encoding overlaps the render loop.
+        sf::RenderTexture target(frameSize);
+
+        for (unsigned long frame = 0; frame < settings.frameCount; ++frame) {
+            replay.inputForTick(game.getTickCount() + 1, tickInput);
+            game.tick(tickInput);
+
+            target.clear();
+            game.drawScene(target);
+            target.display();
+
+            encoder.submit(frame, target.getTexture().copyToImage());
+        }
+    }
+
+    sf::Time renderTime = captureClock.getElapsedTime();
+    encoder.finish();
+
+    sf::Time totalTime = captureClock.getElapsedTime();
+    float simulatedSeconds = settings.frameCount / game.getFramerate();
+
+    std::cout << "Captured " << settings.frameCount << " frames (" << frameSize.x << "x"
+              << frameSize.y << (settings.softwareRenderer ? ", software" : "") << "): render loop " << renderTime.asSeconds() << " s, with encoding "
+              << totalTime.asSeconds() << " s, " << simulatedSeconds / std::max(totalTime.asSeconds(), 0.001f)
+              << "x real time, " << encoder.getBackpressureWaits() << " encoder waits" << std::endl;
+
+    if (encoder.getFailedFrames() > 0) {
+        throw std::runtime_error("Failed to write " + std::to_string(encoder.getFailedFrames()) + " captured frames");
+    }
+}
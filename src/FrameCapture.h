@@ -0,0 +1,33 @@
+#ifndef FRAMECAPTURE_H
+#define FRAMECAPTURE_H
+
+#include <filesystem>
+
+#include "FrameEncoder.h"
+
+class Game;
+
+// Replays a recording on a game without a window as fast as possible, rendering
+// every tick offscreen at base resolution. Each frame is read back
+// synchronously; only the PNG/raw encoding runs on the FrameEncoder's threads.
+class FrameCapture {
+public:
+    struct Settings {
+        std::filesystem::path outputDir = "capture";
+        std::filesystem::path replayPath;  // empty: capture with no input
+        unsigned int frameCount = 600;     // one frame per tick
+        FrameEncoder::Format format = FrameEncoder::Format::PNG;
+        unsigned int workerCount = 0;      // 0: one per hardware thread
+        bool softwareRenderer = false;     // draw on the CPU, with no GPU or GL context
+    };
+
+    FrameCapture(Game& game, const Settings& settings) : game(game), settings(settings) {}
+
+    void run();
+
+private:
+    Game& game;
+    Settings settings;
+};
+
+#endif
@@ -0,0 +1,84 @@
+#include "FrameEncoder.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+FrameEncoder::FrameEncoder(const std::filesystem::path& outputDir, Format format, unsigned int workerCount, std::size_t maxQueuedFrames) :
+    outputDir(outputDir),
+    format(format),
+    maxQueuedFrames(std::max<std::size_t>(1, maxQueuedFrames))
+{
+    std::filesystem::create_directories(outputDir);
+
+    workerCount = std::max(1u, workerCount);
+    for (unsigned int i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&FrameEncoder::workerLoop, this);
+    }
+}
+
+void FrameEncoder::finish() {
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+void FrameEncoder::submit(unsigned long frameIndex, sf::Image&& frame) {
+    std::unique_lock<std::mutex> lock(jobsMutex);
+
+    if (jobs.size() >= maxQueuedFrames) {
+        backpressureWaits++;
+        spaceAvailable.wait(lock, [this] { return jobs.size() < maxQueuedFrames; });
+    }
+
+    jobs.push_back({frameIndex, std::move(frame)});
+    lock.unlock();
+
+    jobAvailable.notify_one();
+}
+
+std::size_t FrameEncoder::getFailedFrames() const {
+    std::lock_guard<std::mutex> lock(jobsMutex);
+    return failedFrames;
+}
+
+void FrameEncoder::workerLoop() {
+    while (true) {
+        std::unique_lock<std::mutex> lock(jobsMutex);
+        jobAvailable.wait(lock, [this] { return stopping || !jobs.empty(); });
+
+        if (jobs.empty()) return;  // stopping and drained
+
+        Job job = std::move(jobs.front());
+        jobs.pop_front();
+        lock.unlock();
+        spaceAvailable.notify_one();
+
+        if (!encode(job)) {
+            lock.lock();
+            failedFrames++;
+        }
+    }
+}
+
+bool FrameEncoder::encode(const Job& job) const {
+    char fileName[32];
+    std::snprintf(fileName, sizeof(fileName), "frame_%06lu.%s", job.frameIndex, format == Format::PNG ? "png" : "rgba");
+    std::filesystem::path framePath = outputDir / fileName;
+
+    if (format == Format::PNG) {
+        return job.image.saveToFile(framePath);
+    }
+
+    sf::Vector2u size = job.image.getSize();
+    std::ofstream file(framePath, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(job.image.getPixelsPtr()), static_cast<std::streamsize>(size.x) * size.y * 4);
+
+    return file.good();
+}
@@ -0,0 +1,66 @@
+#ifndef FRAMEENCODER_H
+#define FRAMEENCODER_H
+
+#include <SFML/Graphics/Image.hpp>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Writes captured frames to disk on a pool of worker threads so the
+// render loop only pays for the hand-off
+class FrameEncoder {
+public:
+    enum class Format {
+        PNG,
+        RAW   // headerless RGBA8, frame size is reported by the capture
+    };
+
+    FrameEncoder(const std::filesystem::path& outputDir, Format format, unsigned int workerCount, std::size_t maxQueuedFrames);
+
+    ~FrameEncoder() { finish(); }
+
+    FrameEncoder(const FrameEncoder&) = delete;
+    FrameEncoder& operator=(const FrameEncoder&) = delete;
+
+    // Blocks only if maxQueuedFrames are already waiting, to bound memory use
+    void submit(unsigned long frameIndex, sf::Image&& frame);
+
+    // Writes every queued frame and stops the workers; no submits afterwards
+    void finish();
+
+    // Number of submits that had to wait for a worker
+    std::size_t getBackpressureWaits() const { return backpressureWaits; }
+
+    std::size_t getFailedFrames() const;
+
+private:
+    struct Job {
+        unsigned long frameIndex;
+        sf::Image image;
+    };
+
+    void workerLoop();
+
+    bool encode(const Job& job) const;
+
+    std::filesystem::path outputDir;
+    Format format;
+    std::size_t maxQueuedFrames;
+
+    std::deque<Job> jobs;
+    mutable std::mutex jobsMutex;
+    std::condition_variable jobAvailable;
+    std::condition_variable spaceAvailable;
+    bool stopping = false;
+
+    std::size_t backpressureWaits = 0;
+    std::size_t failedFrames = 0;
+
+    std::vector<std::thread> workers;
+};
+
+#endif
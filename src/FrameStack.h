@@ -0,0 +1,45 @@
+#ifndef FRAMESTACK_H
+#define FRAMESTACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// The last depth observation frames, kept as a ring in memory the caller owns
+// (e.g. one game's slice of a training batch). A new frame is written straight
+// into the oldest slot, so pushing never moves the other frames.
+class FrameStack {
+public:
+    FrameStack(std::uint8_t* memory, std::size_t frameBytes, unsigned int depth)
+        : memory(memory), frameBytes(frameBytes), depth(depth) {}
+
+    // Where the next frame goes; it becomes the newest on push()
+    std::uint8_t* nextFrame() { return slot((newestSlot + 1) % depth); }
+
+    void push() { newestSlot = (newestSlot + 1) % depth; }
+
+    // Copies the newest frame over every other slot, e.g. at the start of an episode
+    void fillWithNewest() {
+        for (unsigned int i = 0; i < depth; ++i) {
+            if (i != newestSlot) std::memcpy(slot(i), slot(newestSlot), frameBytes);
+        }
+    }
+
+    // The frame age pushes before the newest one; age < depth
+    const std::uint8_t* getFrame(unsigned int age) const { return slot((newestSlot + depth - age) % depth); }
+
+    // Slot of the newest frame; the oldest is the one after it
+    unsigned int getNewestSlot() const { return newestSlot; }
+
+    unsigned int getDepth() const { return depth; }
+
+private:
+    std::uint8_t* slot(unsigned int index) const { return memory + index * frameBytes; }
+
+    std::uint8_t* memory;
+    std::size_t frameBytes;
+    unsigned int depth;
+    unsigned int newestSlot = 0;
+};
+
+#endif
@@ -0,0 +1,70 @@
+#include "FrameStats.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <string>
+
+sf::Time FrameStats::getPercentile(float percentile) const {
+    if (samples.empty()) return sf::Time::Zero;
+
+    std::vector<long long> sorted = samples;
+    float clamped = std::clamp(percentile, 0.0f, 100.0f);
+    std::size_t index = static_cast<std::size_t>(std::round(clamped / 100.0f * (sorted.size() - 1)));
+
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return sf::microseconds(sorted[index]);
+}
+
+sf::Time FrameStats::getMean() const {
+    if (samples.empty()) return sf::Time::Zero;
+
+    long long total = 0;
+    for (long long sample : samples) {
+        total += sample;
+    }
+
+    return sf::microseconds(total / static_cast<long long>(samples.size()));
+}
+
+sf::Time FrameStats::getMax() const {
+    if (samples.empty()) return sf::Time::Zero;
+
+    return sf::microseconds(*std::max_element(samples.begin(), samples.end()));
+}
+
+sf::Time FrameStats::getJitter() const {
+    if (samples.size() < 2) return sf::Time::Zero;
+
+    double mean = static_cast<double>(getMean().asMicroseconds());
+    double sumSquares = 0.0;
+    for (long long sample : samples) {
+        double delta = sample - mean;
+        sumSquares += delta * delta;
+    }
+
+    return sf::microseconds(static_cast<long long>(std::sqrt(sumSquares / samples.size())));
+}
+
+void FrameStats::printHistogram(std::ostream& out, unsigned int bucketCount) const {
+    if (samples.empty() || bucketCount == 0) return;
+
+    auto [minIt, maxIt] = std::minmax_element(samples.begin(), samples.end());
+    long long minSample = *minIt;
+    long long bucketWidth = std::max(1LL, (*maxIt - minSample) / bucketCount + 1);
+
+    std::vector<std::size_t> buckets(bucketCount, 0);
+    for (long long sample : samples) {
+        buckets[(sample - minSample) / bucketWidth]++;
+    }
+
+    std::size_t largestBucket = *std::max_element(buckets.begin(), buckets.end());
+    const std::size_t barWidth = 40;
+
+    for (unsigned int i = 0; i < bucketCount; ++i) {
+        double bucketStartMs = (minSample + i * bucketWidth) / 1000.0;
+        std::size_t barLength = buckets[i] * barWidth / largestBucket;
+
+        out << "    " << std::fixed << std::setprecision(3) << std::setw(8) << bucketStartMs << " ms | "
+            << std::string(barLength, '#') << ' ' << buckets[i] << '\n';
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef FRAMESTATS_H
+#define FRAMESTATS_H
+
+#include <SFML/System/Time.hpp>
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+// Collects per-frame timing samples and summarises them as percentiles,
+// jitter and a text histogram.
+class FrameStats {
+public:
+    void reserve(std::size_t sampleCount) { samples.reserve(sampleCount); }
+
+    void addSample(sf::Time sample) { samples.push_back(sample.asMicroseconds()); }
+
+    void clear() { samples.clear(); }
+
+    std::size_t getSampleCount() const { return samples.size(); }
+
+    // percentile in [0, 100]
+    sf::Time getPercentile(float percentile) const;
+
+    sf::Time getMean() const;
+
+    sf::Time getMax() const;
+
+    // Standard deviation of the samples, used as the frame-time jitter
+    sf::Time getJitter() const;
+
+    void printHistogram(std::ostream& out, unsigned int bucketCount) const;
+
+private:
+    std::vector<long long> samples;  // microseconds
+};
+
+#endif
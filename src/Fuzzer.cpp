@@ -0,0 +1,286 @@
+#include "Fuzzer.h"
+#include <SFML/System/Clock.hpp>
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+std::optional<Fuzzer::InvariantFailure> Fuzzer::checkInvariants(const Worker& worker, int previousScore) {
+    const Game& game = *worker.game;
+    const MazeMap& map = game.getMap();
+    const float tileSize = static_cast<float>(map.getTileSize());
+    const sf::Vector2f mazePixels(map.getWidth() * tileSize, map.getHeight() * tileSize);
+
+    auto checkEntity = [&](const Entity& entity, const std::string& name) -> std::optional<InvariantFailure> {
+        sf::Vector2f position = entity.getPosition();
+        if (!(position.x >= 0.0f && position.x < mazePixels.x && position.y >= 0.0f && position.y < mazePixels.y)) {
+            return InvariantFailure{"inside maze", name + " at pixel (" + std::to_string(position.x) + ", " + std::to_string(position.y) + ")"};
+        }
+
+        sf::Vector2i tile = map.getTileCoords(position);
+        std::string at = " at tile (" + std::to_string(tile.x) + ", " + std::to_string(tile.y) + ")";
+        if (map.isWall(tile)) {
+            return InvariantFailure{"on open tile", name + at};
+        }
+        // Moves run between tile centres, so one axis is always on a centre line
+        sf::Vector2f offCentre = position - map.getTargetTileCenter(tile);
+        if (std::abs(offCentre.x) >= map.getCentreTolerance() && std::abs(offCentre.y) >= map.getCentreTolerance()) {
+            return InvariantFailure{"on a centre line", name + at};
+        }
+        return std::nullopt;
+    };
+
+    if (auto failure = checkEntity(game.getPacman(), "Pac-Man")) return failure;
+
+    const std::vector<Ghost>& ghosts = game.getGhosts();
+    for (std::size_t i = 0; i < ghosts.size(); ++i) {
+        const Ghost& ghost = ghosts[i];
+        std::string name = "ghost " + std::to_string(i);
+        if (auto failure = checkEntity(ghost, name)) return failure;
+
+        if (!worker.houseTiles.empty() && ghost.getHasExitedBox()) {
+            sf::Vector2i tile = map.getTileCoords(ghost.getPosition());
+            if (worker.houseTiles[map.convert2DCoords(tile)]) {
+                return InvariantFailure{"out of house once left", name + " at tile (" + std::to_string(tile.x) + ", " + std::to_string(tile.y) + ")"};
+            }
+        }
+    }
+
+    // The danger map starts from every ghost that can catch Pac-Man, and only from those
+    const DangerMap& danger = game.getDangerMap();
+    for (std::size_t i = 0; i < ghosts.size(); ++i) {
+        const Ghost& ghost = ghosts[i];
+        sf::Vector2i tile = map.getTileCoords(ghost.getPosition());
+        std::string at = "ghost " + std::to_string(i) + " at tile (" + std::to_string(tile.x) + ", " + std::to_string(tile.y) + ")";
+
+        if (!ghost.getIsVulnerable() && danger.arrivalTick(tile) == DangerMap::NEVER) {
+            return InvariantFailure{"danger from every dangerous ghost", at};
+        }
+        if (ghost.getIsVulnerable() && danger.arrivalTick(tile) == 0) {
+            bool shared = std::any_of(ghosts.begin(), ghosts.end(), [&](const Ghost& other) {
+                return !other.getIsVulnerable() && map.getTileCoords(other.getPosition()) == tile;
+            });
+            if (!shared) return InvariantFailure{"no danger from vulnerable ghosts", at};
+        }
+    }
+
+    if (game.getScore() < previousScore) {
+        return InvariantFailure{"score never drops", std::to_string(previousScore) + " to " + std::to_string(game.getScore())};
+    }
+
+    std::size_t eaten = 0;
+    for (std::uint64_t word : map.getEatenPellets()) {
+        eaten += std::bitset<64>(word).count();
+    }
+    if (map.dotsRemaining() + eaten != map.getLayout()->getPelletCount()) {
+        return InvariantFailure{"pellet count", std::to_string(map.dotsRemaining()) + " left and " + std::to_string(eaten) +
+                                " eaten of " + std::to_string(map.getLayout()->getPelletCount())};
+    }
+
+    return std::nullopt;
+}
+
+std::vector<bool> Fuzzer::findHouseTiles(const Game& game) {
+    const MazeMap& map = game.getMap();
+
+    // Flood the open tiles below the exit from every ghost that starts inside; a
+    // house that is walled in except for its exit stays small
+    const std::size_t maxHouseTiles = 256;
+    std::vector<bool> house(static_cast<std::size_t>(map.getWidth()) * map.getHeight(), false);
+    std::vector<sf::Vector2i> toVisit;
+    std::size_t houseSize = 0;
+
+    for (const Ghost& ghost : game.getGhosts()) {
+        if (ghost.getHasExitedBox()) continue;
+        toVisit.push_back(map.getTileCoords(ghost.getPosition()));
+    }
+
+    while (!toVisit.empty()) {
+        sf::Vector2i tile = toVisit.back();
+        toVisit.pop_back();
+
+        if (!map.isLegalTile(tile) || tile.y <= game.getGhostBoxExitTile().y || map.isWall(tile)) continue;
+        if (house[map.convert2DCoords(tile)]) continue;
+
+        house[map.convert2DCoords(tile)] = true;
+        if (++houseSize > maxHouseTiles) return {};
+
+        toVisit.push_back({tile.x + 1, tile.y});
+        toVisit.push_back({tile.x - 1, tile.y});
+        toVisit.push_back({tile.x, tile.y + 1});
+        toVisit.push_back({tile.x, tile.y - 1});
+    }
+
+    if (houseSize == 0) return {};
+    return house;
+}
+
+std::optional<Fuzzer::Failure> Fuzzer::playCase(Worker& worker, const Replay& input, long long lastTick) {
+    Game& game = *worker.game;
+    game.loadSnapshot(worker.start);
+    std::vector<InputEvent> tickInput;
+
+    while (game.getTickCount() < lastTick && !game.isGameOver()) {
+        int previousScore = game.getScore();
+        input.inputForTick(game.getTickCount() + 1, tickInput);
+        game.tick(tickInput);
+
+        if (auto failure = checkInvariants(worker, previousScore)) {
+            return Failure{game.getTickCount(), *failure};
+        }
+    }
+
+    return std::nullopt;
+}
+
+Replay Fuzzer::minimizeCase(Worker& worker, const Replay& input, Failure& failure) {
+    // Nothing after the failing tick can matter
+    std::vector<Replay::Entry> entries;
+    for (const Replay::Entry& entry : input.getEntries()) {
+        if (entry.tick <= failure.tick) entries.push_back(entry);
+    }
+
+    auto toReplay = [](const std::vector<Replay::Entry>& kept) {
+        Replay replay;
+        for (const Replay::Entry& entry : kept) {
+            replay.record(entry.tick, {{entry.direction, entry.pressed, sf::Time::Zero}});
+        }
+        return replay;
+    };
+
+    for (std::size_t chunk = std::max<std::size_t>(1, entries.size() / 2); chunk > 0; chunk /= 2) {
+        for (std::size_t first = 0; first < entries.size();) {
+            std::vector<Replay::Entry> candidate(entries.begin(), entries.begin() + first);
+            candidate.insert(candidate.end(), entries.begin() + std::min(first + chunk, entries.size()), entries.end());
+
+            std::optional<Failure> result = playCase(worker, toReplay(candidate), failure.tick);
+            if (result && result->failure.invariant == failure.failure.invariant) {
+                entries = std::move(candidate);
+                failure = *result;
+            } else {
+                first += chunk;
+            }
+        }
+    }
+
+    return toReplay(entries);
+}
+
+void Fuzzer::run() {
+    unsigned int workerCount = settings.workerCount > 0 ? settings.workerCount : std::max(1u, std::thread::hardware_concurrency());
+    workerCount = static_cast<unsigned int>(std::min<std::size_t>(workerCount, std::max<std::size_t>(1, settings.caseCount)));
+
+    std::filesystem::create_directories(settings.outputDir);
+
+    // The assets and maze are loaded once, on this thread; the workers share
+    // them and only ever tick. None of them draws, so no GPU texture either.
+    game.setHeadless(true);
+    game.loadResources();
+
+    std::vector<Worker> workers(workerCount);
+    for (Worker& worker : workers) {
+        worker.game = std::make_unique<Game>(game.getConfigPath());
+        Game& workerGame = *worker.game;
+        workerGame.shareResources(game);
+        workerGame.setupScene();
+        worker.houseTiles = findHouseTiles(workerGame);
+        workerGame.saveSnapshot(worker.start);
+    }
+
+    std::cout << "Fuzzing " << settings.caseCount << " input streams of up to " << settings.ticksPerCase
+              << " ticks on " << workerCount << " threads" << std::endl;
+
+    std::atomic<std::size_t> nextCase{0};
+    std::atomic<unsigned long long> ticksChecked{0};
+    std::mutex reportMutex;
+    std::map<std::string, std::size_t> failuresByInvariant;
+    std::string workerError;
+
+    auto fuzzLoop = [&](unsigned int workerIndex) {
+        Worker& worker = workers[workerIndex];
+        const Game::Snapshot& start = worker.start;
+        const MovementDir directions[] = {MovementDir::UP, MovementDir::DOWN, MovementDir::LEFT, MovementDir::RIGHT};
+
+        try {
+            for (std::size_t caseIndex = nextCase++; caseIndex < settings.caseCount; caseIndex = nextCase++) {
+                std::uint64_t seed = settings.firstSeed + caseIndex;
+
+                // A player who changes their mind every few dozen ticks, sometimes letting go
+                std::mt19937_64 random(seed);
+                std::uniform_int_distribution<int> pickDirection(0, 3);
+                std::uniform_int_distribution<int> oneIn(0, 23);
+
+                Replay input;
+                MovementDir held = MovementDir::STATIC;
+                const long long lastTick = start.tickCount + settings.ticksPerCase;
+                for (long long tickNumber = start.tickCount + 1; tickNumber <= lastTick; ++tickNumber) {
+                    if (oneIn(random) != 0) continue;
+
+                    std::vector<InputEvent> events;
+                    if (held != MovementDir::STATIC) {
+                        events.push_back({held, false, sf::Time::Zero});
+                        held = MovementDir::STATIC;
+                    }
+                    if (oneIn(random) % 4 != 0) {
+                        held = directions[pickDirection(random)];
+                        events.push_back({held, true, sf::Time::Zero});
+                    }
+                    input.record(tickNumber, events);
+                }
+
+                std::optional<Failure> failure = playCase(worker, input, lastTick);
+                ticksChecked += static_cast<unsigned long long>(worker.game->getTickCount() - start.tickCount);
+                if (!failure) continue;
+
+                Replay minimized = minimizeCase(worker, input, *failure);
+                std::filesystem::path replayPath = settings.outputDir / ("failure_" + std::to_string(seed) + ".txt");
+                bool saved = minimized.saveToFile(replayPath);
+
+                std::lock_guard<std::mutex> lock(reportMutex);
+                failuresByInvariant[failure->failure.invariant]++;
+                std::cout << "Seed " << seed << ": \"" << failure->failure.invariant << "\" broken at tick " << failure->tick
+                          << ": " << failure->failure.detail << "; " << minimized.getEntries().size() << " of "
+                          << input.getEntries().size() << " inputs kept"
+                          << (saved ? ", replay " + replayPath.string() : ", replay could not be written") << std::endl;
+            }
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lock(reportMutex);
+            if (workerError.empty()) workerError = e.what();
+            nextCase = settings.caseCount;
+        }
+    };
+
+    sf::Clock clock;
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < workerCount; ++i) {
+        threads.emplace_back(fuzzLoop, i);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::max(clock.getElapsedTime().asMicroseconds() / 1e6, 1e-9);
+
+    if (!workerError.empty()) {
+        throw std::runtime_error("Fuzzing stopped: " + workerError);
+    }
+
+    std::size_t failureCount = 0;
+    for (const auto& [invariant, count] : failuresByInvariant) {
+        failureCount += count;
+    }
+
+    std::cout << std::fixed << std::setprecision(1)
+              << ticksChecked.load() << " ticks checked in " << seconds << " s (" << ticksChecked.load() / seconds
+              << " ticks/s), " << failureCount << " failing streams\n";
+    for (const auto& [invariant, count] : failuresByInvariant) {
+        std::cout << "    " << std::setw(6) << count << "  " << invariant << '\n';
+    }
+    std::cout << std::flush;
+}
@@ -0,0 +1,70 @@
+#ifndef FUZZER_H
+#define FUZZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Game.h"
+#include "Replay.h"
+
+// Plays random input streams on headless copies of a game in parallel and
+// checks the simulation invariants after every tick. Each failing stream is
+// cut down to the fewest inputs that still break the same invariant and saved
+// in outputDir as a replay for --capture --replay.
+class Fuzzer {
+public:
+    struct Settings {
+        std::uint64_t firstSeed = 1;
+        std::size_t caseCount = 1000;        // one random input stream per seed
+        unsigned int ticksPerCase = 3600;    // or until game over
+        unsigned int workerCount = 0;        // 0: one per hardware thread
+        std::filesystem::path outputDir = "fuzz";
+    };
+
+    Fuzzer(Game& game, const Settings& settings) : game(game), settings(settings) {}
+
+    void run();
+
+private:
+    struct InvariantFailure {
+        std::string invariant;  // which check failed; the same for every failure it catches
+        std::string detail;
+    };
+
+    struct Failure {
+        long long tick;
+        InvariantFailure failure;
+    };
+
+    // One thread's game, set up on the assets the fuzzed game loaded
+    struct Worker {
+        std::unique_ptr<Game> game;
+        Game::Snapshot start;          // where every case begins
+        std::vector<bool> houseTiles;  // from findHouseTiles()
+    };
+
+    // Cheap checks of the state tick() left behind: every entity inside the maze
+    // on an open tile and on a corridor centre line, ghosts that left the house not back
+    // in it, a score that never drops and a pellet count that matches the eaten pellets
+    static std::optional<InvariantFailure> checkInvariants(const Worker& worker, int previousScore);
+
+    // Tiles of the ghost house below the exit, or none if the house is not walled in
+    static std::vector<bool> findHouseTiles(const Game& game);
+
+    // Plays input from the worker's start until lastTick or game over, checking invariants after every tick
+    static std::optional<Failure> playCase(Worker& worker, const Replay& input, long long lastTick);
+
+    // Drops inputs, halving the chunk size down to single entries, while the
+    // replay still breaks the same invariant; failure is updated to the last one seen
+    static Replay minimizeCase(Worker& worker, const Replay& input, Failure& failure);
+
+    Game& game;
+    Settings settings;
+};
+
+#endif
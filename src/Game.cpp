@@ -1,8 +1,13 @@
+#include <SFML/Graphics/RectangleShape.hpp>
+#include <SFML/Graphics/RenderTexture.hpp>
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/System/Time.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <SFML/Audio.hpp>
 #include <string>
 #include <stdexcept>
@@ -11,11 +16,16 @@
 #include "Blinky.h"
 #include "Clyde.h"
 #include "Entity.h"
+#include "FileWatcher.h"
+#include "FrameStats.h"
+#include "InputQueue.h"
 #include "Inky.h"
 #include "MazeMap.h"
 #include "Pinky.h"
+#include "Replay.h"
 #include "ResourceManager.h"
 #include "Pacman.h"
+#include "SweptContact.h"
 
 json Game::loadConfig(const std::filesystem::path& configPath) {
     std::ifstream file(configPath);
@@ -33,206 +43,578 @@ json Game::loadConfig(const std::filesystem::path& configPath) {
     }
 }
 
+Game::Tuning Game::parseTuning(const json& config) {
+    Tuning parsed;
+
+    try {
+        const json& constants = config.at("gameConstants");
+        float speed = constants.at("baseSpeedPixelsPerSecond").get<float>();
+        float frameRate = constants.at("frameRate").get<float>();
+        parsed.perPixelMove = speed / frameRate;
+        float ghostSpeed = constants.at("ghostSpeedTilesPerSecond").get<float>();
+        parsed.perPixelGhostMove = ghostSpeed * constants.at("tileSize").get<float>() / frameRate;
+        parsed.ghostEatenPoints = constants.at("ghostEatenPoints").get<std::vector<int>>();
+
+        if (!(speed > 0.0f) || !(ghostSpeed > 0.0f) || !(frameRate > 0.0f)) {
+            throw std::runtime_error("baseSpeedPixelsPerSecond, ghostSpeedTilesPerSecond and frameRate must be positive");
+        }
+        if (parsed.ghostEatenPoints.empty()) {
+            throw std::runtime_error("ghostEatenPoints must not be empty");
+        }
+    } catch (const json::exception& e) {
+        throw std::runtime_error("Invalid config: " + std::string(e.what()));
+    }
+
+    return parsed;
+}
+
 Game::Game(const std::filesystem::path& configPath) : 
+    configPath(configPath),
     config(loadConfig(configPath)),
     framerate(static_cast<float>(config["gameConstants"]["frameRate"])),
-    perPixelMove(static_cast<float>(config["gameConstants"]["baseSpeedPixelsPerSecond"]) / static_cast<float>(config["gameConstants"]["frameRate"])),
-    baseTileSize(static_cast<int>(config["gameConstants"]["tileSize"]))
+    baseTileSize(static_cast<int>(config["gameConstants"]["tileSize"])),
+    tuning(parseTuning(config))
 {};
 
-void Game::run() {
-    const int tileSize = baseTileSize * scaleFactor;
-    const float perLoopMove = perPixelMove * scaleFactor;
-
-    ResourceManager resources;
-    MazeMap map;
-
-    resources.loadTexture("all_textures", "assets/textures/all_textures_transparent.png");
-    // resize all_textures to 32px
-    resources.resizeTexture("all_textures", tileSize);
-    // Collision data: 1=wall, 0=path
-    resources.loadMap("mazeMap", "assets/game/maze.txt");
-    // Pellet data: 0=none, 1=pellet, 2=power
-    resources.loadMap("pelletMap", "assets/game/pellets.txt");
-
-    resources.loadFont("bitFont", "assets/fonts/PressStart2P.ttf");
-
-    resources.loadSound("credit", "assets/sounds/credit.wav");
-    resources.loadSound("death_0", "assets/sounds/death_0.wav");
-    resources.loadSound("death_1", "assets/sounds/death_1.wav");
-    resources.loadSound("eat_dot_0", "assets/sounds/eat_dot_0.wav");
-    resources.loadSound("eat_dot_1", "assets/sounds/eat_dot_1.wav");
-    resources.loadSound("eat_fruit", "assets/sounds/eat_fruit.wav");
-    resources.loadSound("eat_ghost", "assets/sounds/eat_ghost.wav");
-    resources.loadSound("extend", "assets/sounds/extend.wav");
-    resources.loadSound("eyes", "assets/sounds/eyes.wav");
-    resources.loadSound("eyes_firstloop", "assets/sounds/eyes_firstloop.wav");
-    resources.loadSound("fright", "assets/sounds/fright.wav");
-    resources.loadSound("fright_firstloop", "assets/sounds/fright_firstloop.wav");
-    resources.loadSound("intermission.wav", "assets/sounds/intermission.wav");
-    resources.loadSound("siren0", "assets/sounds/siren0.wav");
-    resources.loadSound("siren0_firstloop", "assets/sounds/siren0_firstloop.wav");
-    resources.loadSound("siren1", "assets/sounds/siren1.wav");
-    resources.loadSound("siren1_firstloop", "assets/sounds/siren1_firstloop.wav");
-    resources.loadSound("siren2", "assets/sounds/siren2.wav");
-    resources.loadSound("siren2_firstloop", "assets/sounds/siren2_firstloop.wav");
-    resources.loadSound("siren3", "assets/sounds/siren3.wav");
-    resources.loadSound("siren3_firstloop", "assets/sounds/siren3_firstloop.wav");
-    resources.loadSound("siren4", "assets/sounds/siren4.wav");
-    resources.loadSound("siren4_firstloop", "assets/sounds/siren4_firstloop.wav");
-    resources.loadSound("start", "assets/sounds/start.wav");
-
-    // Texture layout: [Pellet Maze Image] + gap (4px at base scale) + [Base Maze Image]
-    // Original: 224px (28*8) + 4px gap at 8px tiles
-    // Gap scales with tile size: (28 * tileSize) + (4 * scaleFactor)
+void Game::loadResources() {
+    // A missing pack is fine: every asset also loads from its own file
+    if (!assetPackPath.empty()) {
+        resources->openPack(assetPackPath);
+    }
+
+    if (generatedMazeSettings) {
+        generatedMaze = MazeGenerator(*generatedMazeSettings).generate(generatedMazeSeed);
+        resources->setMap("mazeMap", generatedMaze->collisionData, generatedMaze->size);
+        resources->setMap("pelletMap", generatedMaze->pelletData, generatedMaze->size);
+    } else {
+        // Collision data: 1=wall, 0=path
+        if (!resources->loadMap("mazeMap", mazePath)) {
+            throw std::runtime_error("Could not load maze: " + mazePath.string());
+        }
+        // Pellet data: 0=none, 1=pellet, 2=power
+        if (!resources->loadMap("pelletMap", pelletPath)) {
+            throw std::runtime_error("Could not load pellets: " + pelletPath.string());
+        }
+        generatedMaze.reset();
+    }
+    if (resources->getMapSize("mazeMap") != resources->getMapSize("pelletMap")) {
+        throw std::runtime_error("Maze and pellet maps differ in size");
+    }
+
+    // The atlas stays at its 1x size; the finished scene is upscaled instead
+    if (softwareRendering) {
+        // Only the CPU copy is needed; the texture stays empty and sprites just carry their rects
+        if (!resources->loadImage("all_textures", "assets/textures/all_textures_transparent.png")) {
+            throw std::runtime_error("Could not load assets/textures/all_textures_transparent.png");
+        }
+    } else {
+        resources->loadTexture("all_textures", "assets/textures/all_textures_transparent.png");
+    }
+
+    // The score's digits, rendered from PressStart2P's glyph bitmaps at its own
+    // 8-pixel grid. An image rather than the font, so that nothing needs a GL
+    // context to bake them and scenes drawn without a GPU show them too
+    if (!resources->loadImage("scoreDigits", "assets/fonts/PressStart2P_digits8.png")) {
+        throw std::runtime_error("Could not load assets/fonts/PressStart2P_digits8.png");
+    }
+
+    resources->loadSound("credit", "assets/sounds/credit.wav");
+    resources->loadSound("death_0", "assets/sounds/death_0.wav");
+    resources->loadSound("death_1", "assets/sounds/death_1.wav");
+    resources->loadSound("eat_dot_0", "assets/sounds/eat_dot_0.wav");
+    resources->loadSound("eat_dot_1", "assets/sounds/eat_dot_1.wav");
+    resources->loadSound("eat_fruit", "assets/sounds/eat_fruit.wav");
+    resources->loadSound("eat_ghost", "assets/sounds/eat_ghost.wav");
+    resources->loadSound("extend", "assets/sounds/extend.wav");
+    resources->loadSound("eyes", "assets/sounds/eyes.wav");
+    resources->loadSound("eyes_firstloop", "assets/sounds/eyes_firstloop.wav");
+    resources->loadSound("fright", "assets/sounds/fright.wav");
+    resources->loadSound("fright_firstloop", "assets/sounds/fright_firstloop.wav");
+    resources->loadSound("intermission.wav", "assets/sounds/intermission.wav");
+    resources->loadSound("siren0", "assets/sounds/siren0.wav");
+    resources->loadSound("siren0_firstloop", "assets/sounds/siren0_firstloop.wav");
+    resources->loadSound("siren1", "assets/sounds/siren1.wav");
+    resources->loadSound("siren1_firstloop", "assets/sounds/siren1_firstloop.wav");
+    resources->loadSound("siren2", "assets/sounds/siren2.wav");
+    resources->loadSound("siren2_firstloop", "assets/sounds/siren2_firstloop.wav");
+    resources->loadSound("siren3", "assets/sounds/siren3.wav");
+    resources->loadSound("siren3_firstloop", "assets/sounds/siren3_firstloop.wav");
+    resources->loadSound("siren4", "assets/sounds/siren4.wav");
+    resources->loadSound("siren4_firstloop", "assets/sounds/siren4_firstloop.wav");
+    resources->loadSound("start", "assets/sounds/start.wav");
+
+    // Built now, while only this thread uses the manager
+    resources->getMazeLayout();
+    createSounds();
+};
+
+void Game::shareResources(const Game& loaded) {
+    resources = loaded.resources;
+    sharesResources = true;
+    generatedMazeSettings = loaded.generatedMazeSettings;
+    generatedMaze = loaded.generatedMaze;
+    headless = loaded.headless;
+    softwareRendering = loaded.softwareRendering;
+    createSounds();
+};
+
+void Game::createSounds() {
+    pellet0.emplace(*resources->getSound("eat_dot_0"));
+    pellet1.emplace(*resources->getSound("eat_dot_1"));
+    fright.emplace(*resources->getSound("fright"));
+    eatGhost.emplace(*resources->getSound("eat_ghost"));
+};
+
+void Game::setupScene() {
+    // The scene is laid out in base (1x) pixels whatever the scale factor;
+    // presentScene() does the scaling
+    const int tileSize = baseTileSize;
+    const float perLoopMove = tuning.perPixelMove;
+
+    // Texture layout: [Pellet Maze Image] + 4px gap + [Base Maze Image]
     const unsigned int mazePixelWidth = 28 * tileSize;
-    const unsigned int gapWidth = 4 * scaleFactor;
-    map.loadMaze(resources.getMazeMap(),
-                 resources.getPelletMap(),
-                 resources.getTexture("all_textures"),
-                 tileSize,
-                 {mazePixelWidth + gapWidth, 0},
-                 {0, 0});
-
-
-    Pacman pacman;
-
-    Ghost blinky(Ghost::AIType::BLINKY);
-    Ghost pinky(Ghost::AIType::PINKY);
-    Ghost inky(Ghost::AIType::INKY);
-    Ghost clyde(Ghost::AIType::CLYDE);
-
-    pacman.setAnimationTiles(resources.getTexture("all_textures"), {1368, 0}, "right_walking", {45, 45}, 2, 0);
-    pacman.setAnimationTiles(resources.getTexture("all_textures"), {1368, 48}, "left_walking", {45, 45}, 2, 0);
-    pacman.setAnimationTiles(resources.getTexture("all_textures"), {1368, 96}, "up_walking", {45, 45}, 2, 0);
-    pacman.setAnimationTiles(resources.getTexture("all_textures"), {1368, 144}, "down_walking", {45, 45}, 2, 0);
-    pacman.setAnimationTiles(resources.getTexture("all_textures"), {1464, 0}, "static", {45, 45}, 1, 0);
-    pacman.setAnimationTiles(resources.getTexture("all_textures"), {1512, 0}, "death", {45, 45}, 11, 3);
+    const unsigned int gapWidth = 4;
+    // The pre-drawn maze image only matches the classic layout; other mazes get flat walls
+    const sf::Vector2u mazeSize = resources->getMapSize("mazeMap");
+    const bool classicMaze = !generatedMazeSettings && mazeSize == playfieldTiles;
+    map = MazeMap();
+    if (!map.loadMaze(resources->getMazeLayout(),
+                      resources->getTexture("all_textures"),
+                      tileSize,
+                      classicMaze ? std::optional<sf::Vector2u>({mazePixelWidth + gapWidth, 0}) : std::nullopt,
+                      {0, 0})) {
+        throw std::runtime_error("Maze data does not match its size");
+    }
+
+    // Tile centre of an entity's start position; the classic layout starts
+    // some entities between two tiles, so it keeps its hand-placed positions.
+    // Generated mazes come with their own; other mazes get the open tile
+    // nearest the same relative spot
+    const auto startPosition = [&](sf::Vector2f classicTile) {
+        if (classicMaze) {
+            return sf::Vector2f(classicTile.x * tileSize - (tileSize / 2.0f), classicTile.y * tileSize - (tileSize / 2.0f));
+        }
+        return map.getTargetTileCenter(mapClassicTile(classicTile));
+    };
+
+    const sf::Vector2i entitySize = {15, 15};
+    const unsigned int entityGap = 1;
+    const float entityOrigin = 7.5f;
+    sf::Texture& atlas = resources->getTexture("all_textures");
+
+    pacman = Pacman();
+
+    pacman.setAnimationTiles(atlas, {456, 0}, "right_walking", entitySize, 2, 0);
+    pacman.setAnimationTiles(atlas, {456, 16}, "left_walking", entitySize, 2, 0);
+    pacman.setAnimationTiles(atlas, {456, 32}, "up_walking", entitySize, 2, 0);
+    pacman.setAnimationTiles(atlas, {456, 48}, "down_walking", entitySize, 2, 0);
+    pacman.setAnimationTiles(atlas, {488, 0}, "static", entitySize, 1, 0);
+    pacman.setAnimationTiles(atlas, {504, 0}, "death", entitySize, 11, entityGap);
     pacman.setActiveSprite("static", 0);
-    pacman.setOrigin({22.5, 22.5});
+    pacman.setOrigin({entityOrigin, entityOrigin});
     // Tile center = tile * tileSize + tileSize/2
-    pacman.setPosition({14.5f * tileSize - (tileSize / 2.0f), 24.0f * tileSize - (tileSize / 2.0f)});
+    pacmanStartPosition = generatedMaze ? map.getTargetTileCenter(generatedMaze->pacmanStartTile) : startPosition({14.5f, 24.0f});
+    pacman.setPosition(pacmanStartPosition);
     pacman.setMovementSpeed({perLoopMove, perLoopMove});
-  
-    blinky.setAnimationTiles(resources.getTexture("all_textures"), {1368, 192}, "right_walking", {45, 45}, 2, 3);
-    blinky.setAnimationTiles(resources.getTexture("all_textures"), {1464, 192}, "left_walking", {45, 45}, 2, 3);
-    blinky.setAnimationTiles(resources.getTexture("all_textures"), {1560, 192}, "up_walking", {45, 45}, 2, 3);
-    blinky.setAnimationTiles(resources.getTexture("all_textures"), {1656, 192}, "down_walking", {45, 45}, 2, 3);
-    blinky.setActiveSprite("left_walking", 0);
-    blinky.setOrigin({22.5, 22.5});
-    blinky.setPosition({14.5f * tileSize - (tileSize / 2.0f), 12.0f * tileSize - (tileSize / 2.0f)});
-
-    pinky.setAnimationTiles(resources.getTexture("all_textures"), {1368, 240}, "right_walking", {45, 45}, 2, 3);
-    pinky.setAnimationTiles(resources.getTexture("all_textures"), {1464, 240}, "left_walking", {45, 45}, 2, 3);
-    pinky.setAnimationTiles(resources.getTexture("all_textures"), {1560, 240}, "up_walking", {45, 45}, 2, 3);
-    pinky.setAnimationTiles(resources.getTexture("all_textures"), {1656, 240}, "down_walking", {45, 45}, 2, 3);
-    pinky.setActiveSprite("down_walking", 0);
-    pinky.setOrigin({22.5, 22.5});
-    pinky.setPosition({14.5f * tileSize - (tileSize / 2.0f), 15.0f * tileSize - (tileSize / 2.0f)});
-
-    inky.setAnimationTiles(resources.getTexture("all_textures"), {1368, 288}, "right_walking", {45, 45}, 2, 3);
-    inky.setAnimationTiles(resources.getTexture("all_textures"), {1464, 288}, "left_walking", {45, 45}, 2, 3);
-    inky.setAnimationTiles(resources.getTexture("all_textures"), {1560, 288}, "up_walking", {45, 45}, 2, 3);
-    inky.setAnimationTiles(resources.getTexture("all_textures"), {1656, 288}, "down_walking", {45, 45}, 2, 3);
-    inky.setActiveSprite("up_walking", 0);
-    inky.setOrigin({22.5, 22.5});
-    inky.setPosition({12.5f * tileSize - (tileSize / 2.0f), 15.0f * tileSize - (tileSize / 2.0f)});
-
-    clyde.setAnimationTiles(resources.getTexture("all_textures"), {1368, 336}, "right_walking", {45, 45}, 2, 3);
-    clyde.setAnimationTiles(resources.getTexture("all_textures"), {1464, 336}, "left_walking", {45, 45}, 2, 3);
-    clyde.setAnimationTiles(resources.getTexture("all_textures"), {1560, 336}, "up_walking", {45, 45}, 2, 3);
-    clyde.setAnimationTiles(resources.getTexture("all_textures"), {1656, 336}, "down_walking", {45, 45}, 2, 3);
-    clyde.setActiveSprite("up_walking", 0);
-    clyde.setOrigin({22.5, 22.5});
-    clyde.setPosition({16.5f * tileSize - (tileSize / 2.0f), 15.0f * tileSize - (tileSize / 2.0f)});
-
-    // Set up ghost box boundaries for all ghosts
-    // Exit tile is at (14, 12), boundary is Y=12 (don't allow ghosts below this Y)
-    blinky.setBoxExitTile({14, 12});
-    blinky.setBoxBoundaryY(12);
-    
-    pinky.setBoxExitTile({14, 12});
-    pinky.setBoxBoundaryY(12);
-    inky.setBoxExitTile({14, 12});
-    inky.setBoxBoundaryY(12);
-    clyde.setBoxExitTile({14, 12});
-    clyde.setBoxBoundaryY(12);
-
-    // Initialize ghost modes (start in Scatter)
-    blinky.setMode(Ghost::Mode::SCATTER);
-    pinky.setMode(Ghost::Mode::SCATTER);
-    inky.setMode(Ghost::Mode::SCATTER);
-    clyde.setMode(Ghost::Mode::SCATTER);
 
-    // Mode scheduler: simple alternating scatter/chase timer
-    sf::Clock modeClock;
-    const float scatterDurationSeconds = 7.0f;
-    const float chaseDurationSeconds = 20.0f;
-    bool currentlyScatter = true;
-    modeClock.restart();
-
-    // Ghost exit timers (staggered release from ghost box)
-    sf::Clock blinkyExitClock;
-    sf::Clock pinkyExitClock;
-    sf::Clock inkyExitClock;
-    sf::Clock clydeExitClock;
-    
-    // Offset timers by the intro pause (~5s) so ghosts release after intro
-    const float blinkyExitDelaySeconds = 5.0f;   // Blinky exits after 5 seconds (intro offset)
-    const float pinkyExitDelaySeconds = 10.0f;   // Pinky exits after 10 seconds
-    const float inkyExitDelaySeconds = 15.0f;    // Inky exits after 15 seconds
-    const float clydeExitDelaySeconds = 20.0f;   // Clyde exits after 20 seconds
-    
-    bool blinkyReleased = true;   // Blinky starts immediately
-    bool pinkyReleased = false;
-    bool inkyReleased = false;
-    bool clydeReleased = false;
-
-    // Vulnerable mode timer
-    sf::Clock vulnerableTimer;
-    bool vulnerableModeActive = false;
-    const float vulnerableDurationSeconds = 8.0f;  // Duration of vulnerable mode
+    struct GhostSetup {
+        Ghost::AIType type;
+        int sheetRow;
+        const char* initialAnimation;
+        sf::Vector2f startTile;
+        float releaseDelaySeconds;  // from the start of the game, offset by the intro pause
+    };
+
+    // Blinky starts outside the box and is released immediately
+    const GhostSetup ghostSetups[] = {
+        {Ghost::AIType::BLINKY, 64, "left_walking", {14.5f, 12.0f}, 0.0f},
+        {Ghost::AIType::PINKY, 80, "down_walking", {14.5f, 15.0f}, 10.0f},
+        {Ghost::AIType::INKY, 96, "up_walking", {12.5f, 15.0f}, 15.0f},
+        {Ghost::AIType::CLYDE, 112, "up_walking", {16.5f, 15.0f}, 20.0f},
+    };
+
+    ghosts.clear();
+    ghostReleaseTicks.clear();
+
+    sf::Vector2i boxExitTile(14, 12);
+    if (generatedMaze) {
+        boxExitTile = generatedMaze->houseDoorTile;
+    } else if (!classicMaze) {
+        boxExitTile = mapClassicTile({14.0f, 12.0f});
+    }
+    ghostBoxExitTile = boxExitTile;
+
+    // One ghost of each type, already grouped
+    ghostTypeStart = {0, 1, 2, 3, 4};
+
+    for (const GhostSetup& setup : ghostSetups) {
+        Ghost& ghost = ghosts.emplace_back(setup.type);
+        ghostReleaseTicks.push_back(secondsToTicks(setup.releaseDelaySeconds));
+
+        ghost.setAnimationTiles(atlas, {456, setup.sheetRow}, "right_walking", entitySize, 2, entityGap);
+        ghost.setAnimationTiles(atlas, {488, setup.sheetRow}, "left_walking", entitySize, 2, entityGap);
+        ghost.setAnimationTiles(atlas, {520, setup.sheetRow}, "up_walking", entitySize, 2, entityGap);
+        ghost.setAnimationTiles(atlas, {552, setup.sheetRow}, "down_walking", entitySize, 2, entityGap);
+        ghost.setActiveSprite(setup.initialAnimation, 0);
+        ghost.setOrigin({entityOrigin, entityOrigin});
+        ghost.setPosition(generatedMaze ? map.getTargetTileCenter(generatedMaze->ghostStartTiles[static_cast<std::size_t>(setup.type)])
+                                        : startPosition(setup.startTile));
+        ghost.setHomePosition(ghost.getPosition());
+
+        // Ghosts leave the house through the exit tile and, once out, never go
+        // back below its row
+        ghost.setBoxExitTile(boxExitTile);
+        ghost.setBoxBoundaryY(boxExitTile.y);
+
+        ghost.setMovementSpeed({tuning.perPixelGhostMove, tuning.perPixelGhostMove});
+
+        // Ghosts start in Scatter
+        ghost.setMode(Ghost::Mode::SCATTER);
+    }
 
-    auto window = sf::RenderWindow(sf::VideoMode(windowRes), windowName);
+    occupancy.reset({map.getWidth(), map.getHeight()}, ghosts.size() + 1);
+    pacman.setOccupancyGrid(&occupancy, 0);
+    for (std::size_t i = 0; i < ghosts.size(); ++i) {
+        ghosts[i].setOccupancyGrid(&occupancy, i + 1);
+    }
+    updateOccupancy();
+
+    tickCount = 0;
+    modeStartTick = 0;
+    currentlyScatter = true;
+    vulnerableModeActive = false;
+    vulnerableStartTick = 0;
+    ghostsEatenThisFright = 0;
+    roundStartTick = 0;
+    livesRemaining = 2;
+    gameOver = false;
+    heldDirections.clear();
+    pelletSoundCount = 0;
+    updateDangerMap();
+
+    score = 0;
+    // Built once; score updates then only patch changed digit quads. The
+    // font's 8-pixel grid keeps the digits crisp when the scene is upscaled
+    const sf::Image& digitStrip = resources->getImage("scoreDigits");
+    if (!digitAtlas && digitStrip.getSize().x > 0) {
+        digitAtlas.emplace(digitStrip, !softwareRendering);
+        scoreDisplay.setAtlas(*digitAtlas, 7);
+    }
+    scoreDisplay.setValue(score);
+    scoreDisplay.setPosition({5.0f, tileSize * 31.0f + 5.0f});
 
-    sf::Sound sound(*resources.getSound("start"));
-    //sound.play();
+    const sf::IntRect lifeRect = {{585, 17}, {13, 13}};
+    const sf::IntRect fruitRect = {{489, 48}, {15, 15}};
+
+    pacmanLifeOne.emplace(atlas, lifeRect);
+    pacmanLifeOne->setOrigin({13.0f, 0.0f});
+    pacmanLifeOne->setPosition({tileSize * 28.0f, tileSize * 31.0f});
+
+    pacmanLifeTwo.emplace(atlas, lifeRect);
+    pacmanLifeTwo->setOrigin({13.0f, 0.0f});
+    pacmanLifeTwo->setPosition({tileSize * 26.5f, tileSize * 31.0f});
+
+    fruitOne.emplace(atlas, fruitRect);
+    fruitOne->setOrigin({15.0f, 0.0f});
+    fruitOne->setPosition({tileSize * 16.0f, tileSize * 31.0f});
+
+    fruitTwo.emplace(atlas, fruitRect);
+    fruitTwo->setOrigin({15.0f, 0.0f});
+    fruitTwo->setPosition({tileSize * 14.0f, tileSize * 31.0f});
+
+    // The camera shows one playfield of maze above the HUD
+    const sf::Vector2f playfieldSize(playfieldTiles * static_cast<unsigned int>(tileSize));
+    camera.setSize(playfieldSize);
+    camera.setViewport(sf::FloatRect({0.0f, 0.0f}, {1.0f, playfieldSize.y / baseWindowRes.y}));
+    updateCamera();
+
+    if (softwareRendering) return;
+
+    if (!staticLayer) {
+        staticLayer.emplace(baseWindowRes);
+        staticLayerSprite.emplace(staticLayer->getTexture());
+    }
+    staticLayerNeedsRebuild = true;
+};
+
+void Game::spawnGhosts(std::size_t count, const std::vector<Ghost::AIType>& aiTypes) {
+    // setupScene() built one ghost per AIType in enum order; copies share their sprites
+    const std::vector<Ghost> templates = ghosts;
+
+    std::vector<sf::Vector2i> openTiles;
+    for (unsigned int y = 0; y < map.getHeight(); ++y) {
+        for (unsigned int x = 0; x < map.getWidth(); ++x) {
+            if (!map.isWall({static_cast<int>(x), static_cast<int>(y)})) {
+                openTiles.push_back({static_cast<int>(x), static_cast<int>(y)});
+            }
+        }
+    }
+
+    ghosts.clear();
+    ghosts.reserve(count);
+    ghostReleaseTicks.assign(count, 0);
+    occupancy.reset({map.getWidth(), map.getHeight()}, count + 1);
+    pacman.setOccupancyGrid(&occupancy, 0);
+
+    // Cycling through the AI types, then grouping by type so tick() runs each
+    // targeting policy over one contiguous range
+    std::array<std::size_t, 4> typeCounts = {0, 0, 0, 0};
+    for (std::size_t i = 0; i < count; ++i) {
+        typeCounts[static_cast<std::size_t>(aiTypes[i % aiTypes.size()])]++;
+    }
+
+    ghostTypeStart[0] = 0;
+    for (std::size_t type = 0; type < typeCounts.size(); ++type) {
+        ghostTypeStart[type + 1] = ghostTypeStart[type] + typeCounts[type];
+    }
+
+    for (std::size_t type = 0; type < typeCounts.size(); ++type) {
+        for (std::size_t n = 0; n < typeCounts[type]; ++n) {
+            std::size_t i = ghosts.size();
+            Ghost& ghost = ghosts.emplace_back(templates[type]);
+
+            // Spread evenly over the maze rather than stacked in the house
+            sf::Vector2f position = map.getTargetTileCenter(openTiles[i * openTiles.size() / count]);
+            ghost.teleport(position);
+            ghost.setHomePosition(position);
+            ghost.setHasExitedBox(true);
+            ghost.setOccupancyGrid(&occupancy, i + 1);
+        }
+    }
+
+    updateOccupancy();
+    updateDangerMap();
+};
+
+sf::Vector2i Game::mapClassicTile(sf::Vector2f classicTile) const {
+    sf::Vector2i scaledTile(
+        static_cast<int>(classicTile.x / playfieldTiles.x * map.getWidth()),
+        static_cast<int>(classicTile.y / playfieldTiles.y * map.getHeight())
+    );
+
+    return map.findNearestOpenTile(scaledTile);
+};
+
+void Game::updateCamera() {
+    const sf::Vector2f viewSize = camera.getSize();
+    const sf::Vector2f mazePixels(static_cast<float>(map.getWidth() * map.getTileSize()),
+                                  static_cast<float>(map.getHeight() * map.getTileSize()));
+    const sf::Vector2f focus = pacman.getPosition();
+
+    // Pinned to the top-left on any axis the maze fits in
+    const auto follow = [](float focusPos, float viewExtent, float mazeExtent) {
+        if (mazeExtent <= viewExtent) return viewExtent / 2.0f;
+        return std::clamp(focusPos, viewExtent / 2.0f, mazeExtent - viewExtent / 2.0f);
+    };
+
+    camera.setCenter({follow(focus.x, viewSize.x, mazePixels.x), follow(focus.y, viewSize.y, mazePixels.y)});
+};
+
+unsigned int Game::drawScene(sf::RenderTarget& target) {
+    unsigned int drawCalls = 0;
+
+    updateCamera();
+
+    if (useStaticLayerCache && mazeFitsPlayfield()) {
+        drawCalls += updateStaticLayer();
+        target.draw(*staticLayerSprite);
+        drawCalls++;
+        target.setView(camera);
+    } else {
+        drawCalls += drawHud(target);
+        target.setView(camera);
+        target.draw(map);
+        drawCalls += map.getDrawCallCount();
+    }
+
+    target.draw(pacman);
+    drawCalls++;
+
+    for (const Ghost& ghost : ghosts) {
+        target.draw(ghost);
+        drawCalls++;
+    }
+
+    target.setView(target.getDefaultView());
+
+    return drawCalls;
+};
+
+unsigned int Game::presentScene(sf::RenderTarget& target) {
+    if (!sceneLayer) {
+        sceneLayer.emplace(baseWindowRes);
+        sceneLayerSprite.emplace(sceneLayer->getTexture());
+    }
+
+    sceneLayer->clear();
+    unsigned int drawCalls = drawScene(*sceneLayer);
+    sceneLayer->display();
+
+    // The largest whole multiple of the base resolution that fits, centred;
+    // a window smaller than 1x just crops
+    const sf::Vector2u targetSize = target.getSize();
+    const unsigned int scale = std::max(1u, std::min(targetSize.x / baseWindowRes.x, targetSize.y / baseWindowRes.y));
+    const sf::Vector2i scaledSize(baseWindowRes * scale);
+    const sf::Vector2i offset = (sf::Vector2i(targetSize) - scaledSize) / 2;
+
+    sceneLayerSprite->setScale({static_cast<float>(scale), static_cast<float>(scale)});
+    sceneLayerSprite->setPosition(sf::Vector2f(std::max(offset.x, 0), std::max(offset.y, 0)));
+
+    target.setView(sf::View(sf::FloatRect({0.0f, 0.0f}, sf::Vector2f(targetSize))));
+    target.draw(*sceneLayerSprite);
+    target.setView(target.getDefaultView());
+
+    return drawCalls + 1;
+};
+
+unsigned int Game::drawHud(sf::RenderTarget& target) {
+    unsigned int drawCalls = 3;
 
-    sf::Sound pellet0(*resources.getSound("eat_dot_0"));
-    sf::Sound pellet1(*resources.getSound("eat_dot_1"));
+    target.draw(scoreDisplay);
+    if (livesRemaining >= 1) {
+        target.draw(*pacmanLifeOne);
+        drawCalls++;
+    }
+    if (livesRemaining >= 2) {
+        target.draw(*pacmanLifeTwo);
+        drawCalls++;
+    }
+    target.draw(*fruitOne);
+    target.draw(*fruitTwo);
+
+    return drawCalls;
+};
+
+void Game::drawSceneSoftware(SoftwareRenderer& renderer) {
+    updateCamera();
 
-    sf::Sound fright(*resources.getSound("fright"));
+    renderer.clear();
+    renderer.resetView();
 
-    int pelletSoundCount = 0;
+    // The HUD of drawHud()
+    const auto drawSprite = [&renderer](const sf::Sprite& sprite) {
+        renderer.blit(sprite.getTextureRect(), sprite.getPosition() - sprite.getOrigin());
+    };
+    scoreDisplay.drawSoftware(renderer);
+    if (livesRemaining >= 1) drawSprite(*pacmanLifeOne);
+    if (livesRemaining >= 2) drawSprite(*pacmanLifeTwo);
+    drawSprite(*fruitOne);
+    drawSprite(*fruitTwo);
+
+    // The camera's viewport is the playfield at the top of the window
+    const sf::Vector2f viewSize = camera.getSize();
+    renderer.setView(camera.getCenter() - viewSize / 2.0f, sf::IntRect({0, 0}, sf::Vector2i(viewSize)));
+
+    map.drawSoftware(renderer);
+
+    const auto drawEntity = [&renderer](const Entity& entity) {
+        if (const sf::Sprite* sprite = entity.getActiveSprite()) {
+            renderer.blit(sprite->getTextureRect(), entity.getPosition() + entity.getInterpolationOffset() - entity.getOrigin());
+        }
+    };
+    drawEntity(pacman);
+    for (const Ghost& ghost : ghosts) {
+        drawEntity(ghost);
+    }
+
+    renderer.resetView();
+};
+
+unsigned int Game::updateStaticLayer() {
+    unsigned int drawCalls = 0;
+
+    if (staticLayerNeedsRebuild) {
+        staticLayer->clear();
+        staticLayer->draw(map);
+        drawCalls += map.getDrawCallCount();
+        drawCalls += drawHud(*staticLayer);
+
+        map.clearDirtyTiles();
+        hudDirty = false;
+        staticLayerNeedsRebuild = false;
+    } else {
+        drawCalls += map.redrawDirtyTiles(*staticLayer);
+
+        if (hudDirty) {
+            // The HUD strip sits below the maze; wipe it and draw the HUD again
+            float hudTop = static_cast<float>(playfieldTiles.y * map.getTileSize());
+            sf::Vector2f layerSize(staticLayer->getSize());
+            sf::RectangleShape hudBackground({layerSize.x, layerSize.y - hudTop});
+            hudBackground.setPosition({0.0f, hudTop});
+            hudBackground.setFillColor(sf::Color::Black);
+
+            staticLayer->draw(hudBackground, sf::RenderStates(sf::BlendNone));
+            drawCalls += 1 + drawHud(*staticLayer);
+            hudDirty = false;
+        }
+    }
+
+    if (drawCalls > 0) {
+        staticLayer->display();
+    }
+
+    return drawCalls;
+};
+
+
+void Game::run() {
+    sf::Clock loadClock;
+    loadResources();
+    setupScene();
+    metrics.assetLoad.set(loadClock.getElapsedTime().asSeconds());
+
+    if (metricsExport) {
+        metrics.startExport(*metricsExport);
+    }
+
+    auto window = sf::RenderWindow(sf::VideoMode(getWindowResolution()), windowName);
+    scaleFactorChanged = false;
+    // Held keys stay held through heldDirections; OS auto-repeat would only add
+    // fake presses to the input latency stats and to recorded replays
+    window.setKeyRepeatEnabled(false);
+
+    sf::Sound sound(*resources->getSound("start"));
+    //sound.play();
 
     sf::Clock clock;
 
-    const sf::Time FIXED_TIMESTEP = sf::seconds(1.0f / framerate);
-    sf::Time accumulator = sf::Time::Zero;
+    // Timestamps input events and measures input latency
+    sf::Clock runClock;
+    InputQueue inputQueue;
+    std::vector<InputEvent> tickInput;
 
-    sf::Time initialGameplayPause;
+    FrameStats inputToTickLatency;
+    FrameStats inputToPresentLatency;
+    std::vector<sf::Time> awaitingPresent;
 
-    int score = 0;
-    sf::Font bitFont = resources.getFont("bitFont");
-    sf::Text scoreText(bitFont);
-    scoreText.setString(std::to_string(score));
-    scoreText.setPosition({16.0f, tileSize * 31.0f + 16.0f});
+    Replay recording;
 
-    sf::Sprite pacmanLifeOne(resources.getTexture("all_textures"), {{1755, 51}, {39, 39}});
-    pacmanLifeOne.setOrigin({39, 0});
-    pacmanLifeOne.setPosition({tileSize * 28.0f, tileSize * 31.0f});
+    std::optional<FileWatcher> watcher;
+    if (hotReload) {
+        std::vector<std::filesystem::path> watchedFiles = {configPath};
+        if (!generatedMazeSettings) {
+            watchedFiles.push_back(mazePath);
+            watchedFiles.push_back(pelletPath);
+        }
+        watcher.emplace(watchedFiles, [this](const std::filesystem::path& changedFile) {
+            onWatchedFileChanged(changedFile);
+        });
+    }
+
+    const sf::Time FIXED_TIMESTEP = sf::seconds(1.0f / framerate);
+    sf::Time accumulator = sf::Time::Zero;
 
-    sf::Sprite pacmanLifeTwo(resources.getTexture("all_textures"), {{1755, 51}, {39, 39}});
-    pacmanLifeTwo.setOrigin({39, 0});
-    pacmanLifeTwo.setPosition({tileSize * 26.5f, tileSize * 31.0f});
+    // Ticks owed beyond this budget after a stall are dropped rather than
+    // simulated, so one long frame cannot snowball into ever longer ones
+    const int maxCatchUpTicks = 5;
 
-    sf::Sprite fruitOne(resources.getTexture("all_textures"), {{1467, 144}, {45, 45}});
-    fruitOne.setOrigin({45, 0});
-    fruitOne.setPosition({tileSize * 16.0f, tileSize * 31.0f});
+    window.setVerticalSyncEnabled(pacingMode == PacingMode::VSYNC);
+    bool windowFocused = window.hasFocus();
 
-    sf::Sprite fruitTwo(resources.getTexture("all_textures"), {{1467, 144}, {45, 45}});
-    fruitTwo.setOrigin({45, 0});
-    fruitTwo.setPosition({tileSize * 14.0f, tileSize * 31.0f});
+    // Frame intervals and input latency, reported and reset every reportInterval when asked for
+    FrameStats frameIntervals;
+    sf::Time reportElapsed;
+    const sf::Time reportInterval = sf::seconds(10.0f);
 
     while (window.isOpen())
     {
@@ -242,273 +624,740 @@ void Game::run() {
             {
                 window.close();
             }
+            else if (event->is<sf::Event::FocusLost>())
+            {
+                windowFocused = false;
+            }
+            else if (event->is<sf::Event::FocusGained>())
+            {
+                windowFocused = true;
+            }
+            else if (const auto* keyPressed = event->getIf<sf::Event::KeyPressed>();
+                     keyPressed && (keyPressed->code == sf::Keyboard::Key::Equal || keyPressed->code == sf::Keyboard::Key::Hyphen))
+            {
+                // + and - step through the supported scale factors
+                int step = keyPressed->code == sf::Keyboard::Key::Equal ? 1 : -1;
+                setScaleFactor(std::clamp(scaleFactor + step, supportedScaleFactors[0], supportedScaleFactors[std::size(supportedScaleFactors) - 1]));
+            }
+            else
+            {
+                inputQueue.pushEvent(*event, runClock.getElapsedTime());
+            }
+        }
+
+        // Only the window changes size; the scene stays at base resolution
+        if (scaleFactorChanged) {
+            window.setSize(getWindowResolution());
+            scaleFactorChanged = false;
         }
 
         sf::Time elapsedTime = clock.restart();
         accumulator += elapsedTime;
-        initialGameplayPause += elapsedTime;
+        sf::Time frameStart = runClock.getElapsedTime();
+
+        if (reportFramePacing) {
+            frameIntervals.addSample(elapsedTime);
+        }
+        reportElapsed += elapsedTime;
+        if (reportElapsed >= reportInterval) {
+            reportElapsed = sf::Time::Zero;
+
+            if (reportFramePacing) {
+                std::cout << "Frame pacing: " << frameIntervals.getSampleCount() << " frames, mean "
+                          << frameIntervals.getMean().asMicroseconds() / 1000.0 << " ms, p99 "
+                          << frameIntervals.getPercentile(99).asMicroseconds() / 1000.0 << " ms, jitter "
+                          << frameIntervals.getJitter().asMicroseconds() / 1000.0 << " ms" << std::endl;
+                frameIntervals.clear();
+            }
+
+            if (measureInputLatency && inputToTickLatency.getSampleCount() > 0) {
+                std::cout << "Input latency: " << inputToTickLatency.getSampleCount() << " presses, to tick p50 "
+                          << inputToTickLatency.getPercentile(50).asMicroseconds() / 1000.0 << " ms / p99 "
+                          << inputToTickLatency.getPercentile(99).asMicroseconds() / 1000.0 << " ms, to present p50 "
+                          << inputToPresentLatency.getPercentile(50).asMicroseconds() / 1000.0 << " ms / p99 "
+                          << inputToPresentLatency.getPercentile(99).asMicroseconds() / 1000.0 << " ms" << std::endl;
+                inputToTickLatency.clear();
+                inputToPresentLatency.clear();
+            }
+        }
 
-        while (accumulator >= FIXED_TIMESTEP) {
+        // Each tick consumes the input timestamped before the end of its own
+        // timestep, so catch-up ticks see key events in the order they happened
+        sf::Time tickDeadline = frameStart - accumulator;
+        int catchUpTicks = 0;
+        while (accumulator >= FIXED_TIMESTEP && catchUpTicks < maxCatchUpTicks) {
             accumulator -= FIXED_TIMESTEP;
+            tickDeadline += FIXED_TIMESTEP;
 
-            if (initialGameplayPause > sf::seconds(4.5f)) {
-                    // Check ghost exit timers (staggered release)
-                    if (!pinkyReleased && pinkyExitClock.getElapsedTime() > sf::seconds(pinkyExitDelaySeconds)) {
-                        pinkyReleased = true;
-                    }
-                    if (!inkyReleased && inkyExitClock.getElapsedTime() > sf::seconds(inkyExitDelaySeconds)) {
-                        inkyReleased = true;
-                    }
-                    if (!clydeReleased && clydeExitClock.getElapsedTime() > sf::seconds(clydeExitDelaySeconds)) {
-                        clydeReleased = true;
-                    }
-
-                    // Check if vulnerable mode should end
-                    if (vulnerableModeActive && vulnerableTimer.getElapsedTime() > sf::seconds(vulnerableDurationSeconds)) {
-                        vulnerableModeActive = false;
-                        blinky.setVulnerable(false);
-                        pinky.setVulnerable(false);
-                        inky.setVulnerable(false);
-                        clyde.setVulnerable(false);
-                    }
-
-                    // updates ghost behavior modes when time is up
-                    sf::Time modeElapsed = modeClock.getElapsedTime();
-                    if (currentlyScatter && modeElapsed > sf::seconds(scatterDurationSeconds)) {
-                        // switch to chase
-                        currentlyScatter = false;
-                        modeClock.restart();
-                        blinky.setMode(Ghost::Mode::CHASE);
-                        pinky.setMode(Ghost::Mode::CHASE);
-                        inky.setMode(Ghost::Mode::CHASE);
-                        clyde.setMode(Ghost::Mode::CHASE);
-                    } else if (!currentlyScatter && modeElapsed > sf::seconds(chaseDurationSeconds)) {
-                        // switch to scatter
-                        currentlyScatter = true;
-                        modeClock.restart();
-                        blinky.setMode(Ghost::Mode::SCATTER);
-                        pinky.setMode(Ghost::Mode::SCATTER);
-                        inky.setMode(Ghost::Mode::SCATTER);
-                        clyde.setMode(Ghost::Mode::SCATTER);
-                    }
-
-                sf::Vector2i currentPacmanTile = map.getTileCoords(pacman.getPosition());
-
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W) ||
-                    sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Up)) {
-                    pacman.queueDirection(MovementDir::UP);
-                } else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A) ||
-                    sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Left)) {
-                    pacman.queueDirection(MovementDir::LEFT);
-                } else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S)||
-                    sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Down)) {
-                    pacman.queueDirection(MovementDir::DOWN);
-                } else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D) ||
-                    sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Right)) {
-                    pacman.queueDirection(MovementDir::RIGHT);
-                } else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Q)) {
-                    pacman.queueDirection(MovementDir::STATIC);
-                }
+            if (reloadPending) {
+                applyPendingReload();
+            }
 
-                MovementDir queued = pacman.getQueuedDirection();
-                if (queued != MovementDir::STATIC && queued != pacman.getCurrentDirection()) {
-                    sf::Vector2f currentPos = pacman.getPosition();
-                    sf::Vector2i currentTile = map.getTileCoords(currentPos);
-
-                    const float corneringTolerance = 4.0f;
-                    const float halfTile = tileSize / 2.0f;
-                    bool withinTolerance = false;
-
-                    if (queued == MovementDir::UP || queued == MovementDir::DOWN) {
-                        float tileCenterX = currentTile.x * tileSize + halfTile;
-                        withinTolerance = std::abs(currentPos.x - tileCenterX) <= corneringTolerance;
-                    } else if (queued == MovementDir::LEFT || queued == MovementDir::RIGHT) {
-                        float tileCenterY = currentTile.y * tileSize + halfTile;
-                        withinTolerance = std::abs(currentPos.y - tileCenterY) <= corneringTolerance;
-                    }
-
-                    if (withinTolerance) {
-                        sf::Vector2i targetTile = currentTile;
-
-                        switch (queued) {
-                            case MovementDir::UP:
-                                targetTile.y -= 1;
-                                break;
-                            case MovementDir::DOWN:
-                                targetTile.y += 1;
-                                break;
-                            case MovementDir::LEFT:
-                                targetTile.x -= 1;
-                                if (targetTile.x < 0) targetTile.x = map.getWidth() - 1;
-                                break;
-                            case MovementDir::RIGHT:
-                                targetTile.x += 1;
-                                if (targetTile.x >= static_cast<int>(map.getWidth())) targetTile.x = 0;
-                                break;
-                            case MovementDir::STATIC:
-                                break;
-                        }
-
-                        if (!map.isWall(targetTile)) {
-                            map.snapEntityToGrid(pacman);
-
-                            switch (queued) {
-                                case MovementDir::UP:
-                                    pacman.setActiveSprite("up_walking", 0);
-                                    break;
-                                case MovementDir::DOWN:
-                                    pacman.setActiveSprite("down_walking", 0);
-                                    break;
-                                case MovementDir::LEFT:
-                                    pacman.setActiveSprite("left_walking", 0);
-                                    break;
-                                case MovementDir::RIGHT:
-                                    pacman.setActiveSprite("right_walking", 0);
-                                    break;
-                                case MovementDir::STATIC:
-                                    break;
-                            }
-
-                            sf::Vector2f targetCenter = map.getTargetTileCenter(targetTile);
-                            pacman.startMove(queued, targetCenter);
-                            pacman.clearQueuedDirection();
-                        }
-                    }
+            inputQueue.popUntil(tickDeadline, tickInput);
+            if (!recordPath.empty()) {
+                recording.record(tickCount + 1, tickInput);
+            }
+            tick(tickInput);
+            catchUpTicks++;
+            metrics.ticks.add();
+
+            if (measureInputLatency) {
+                sf::Time tickDone = runClock.getElapsedTime();
+                for (const InputEvent& input : tickInput) {
+                    if (!input.pressed) continue;
+                    inputToTickLatency.addSample(tickDone - input.timestamp);
+                    awaitingPresent.push_back(input.timestamp);
                 }
+            }
+        }
 
-                if (!pacman.isCurrentlyMoving()) {
-                    MovementDir nextDir = MovementDir::STATIC;
-
-                    MovementDir queued = pacman.getQueuedDirection();
-                    if (queued != MovementDir::STATIC && map.entityCanMove(pacman, queued)) {
-                        nextDir = queued;
-                        pacman.clearQueuedDirection();
-                    }
-                    else if (pacman.getCurrentDirection() != MovementDir::STATIC &&
-                             map.entityCanMove(pacman, pacman.getCurrentDirection())) {
-                        nextDir = pacman.getCurrentDirection();
-                    }
-
-                    if (nextDir != MovementDir::STATIC) {
-                        sf::Vector2i currentTile = map.getTileCoords(pacman.getPosition());
-                        sf::Vector2i targetTile = currentTile;
-
-                        switch (nextDir) {
-                            case MovementDir::UP:
-                                targetTile.y -= 1;
-                                pacman.setActiveSprite("up_walking", 0);
-                                break;
-                            case MovementDir::DOWN:
-                                targetTile.y += 1;
-                                pacman.setActiveSprite("down_walking", 0);
-                                break;
-                            case MovementDir::LEFT:
-                                targetTile.x -= 1;
-                                pacman.setActiveSprite("left_walking", 0);
-                                break;
-                            case MovementDir::RIGHT:
-                                targetTile.x += 1;
-                                pacman.setActiveSprite("right_walking", 0);
-                                break;
-                            case MovementDir::STATIC:
-                                break;
-                        }
-
-                        sf::Vector2f targetCenter = map.getTargetTileCenter(targetTile);
-                        pacman.startMove(nextDir, targetCenter);
-                    } else {
-                        pacman.setActiveSprite("static", 0);
-                    }
-                }
+        // Over budget: drop the whole ticks still owed but keep the phase
+        if (accumulator >= FIXED_TIMESTEP) {
+            accumulator = accumulator % FIXED_TIMESTEP;
+        }
 
-                pacman.update();
+        metrics.recordFrame(elapsedTime, catchUpTicks, score);
 
-                //check if blinky is at an intersection
-                //if yes set target tile to pacmans tile
-                //calculate distance for all legal move options
-                //choose option with least distance for blinky to pacman
+        // Draw entities between their previous and current tick positions
+        setInterpolationAlpha(accumulator / FIXED_TIMESTEP);
 
+        window.clear();
 
-                map.handleTunnelWrapping(pacman);
+        presentScene(window);
 
-                // Update Blinky's AI and movement (Blinky is the red ghost) - released immediately
-                if (blinkyReleased) {
-                    blinky.updateAI(map, pacman);
-                    blinky.update();
-                    map.handleTunnelWrapping(blinky);
-                }
+        window.display();
 
-                // Update Pinky's AI and movement (Pinky is the pink ghost) - released after delay
-                if (pinkyReleased) {
-                    pinky.updateAI(map, pacman);
-                    pinky.update();
-                    map.handleTunnelWrapping(pinky);
-                }
+        if (measureInputLatency) {
+            sf::Time presented = runClock.getElapsedTime();
+            for (sf::Time pressedAt : awaitingPresent) {
+                inputToPresentLatency.addSample(presented - pressedAt);
+            }
+            awaitingPresent.clear();
+        }
 
-                // Update Inky's AI and movement (Inky is the blue ghost) - released after delay
-                if (inkyReleased) {
-                    inky.updateAI(map, pacman);
-                    inky.update();
-                    map.handleTunnelWrapping(inky);
-                }
+        paceFrame(clock, FIXED_TIMESTEP - accumulator, windowFocused);
+    }
 
-                // Update Clyde's AI and movement (Clyde is the orange ghost) - released after delay
-                if (clydeReleased) {
-                    clyde.updateAI(map, pacman);
-                    clyde.update();
-                    map.handleTunnelWrapping(clyde);
+    metrics.stopExport();
+
+    if (!recordPath.empty() && !recording.saveToFile(recordPath)) {
+        throw std::runtime_error("Failed to write replay: " + recordPath.string());
+    }
+
+};
+
+void Game::tick(const std::vector<InputEvent>& tickInput) {
+    const int tileSize = baseTileSize;
+
+    // Mode scheduler: simple alternating scatter/chase timer
+    const float scatterDurationSeconds = 7.0f;
+    const float chaseDurationSeconds = 20.0f;
+
+    const float vulnerableDurationSeconds = 8.0f;  // Duration of vulnerable mode
+    const float introPauseSeconds = 4.5f;
+
+    tickCount++;
+
+    pacman.storePreviousPosition();
+    for (Ghost& ghost : ghosts) {
+        ghost.storePreviousPosition();
+    }
+
+    // Apply this tick's key events in order. The most recently pressed key that
+    // is still held wins, and a tap shorter than a tick still queues its direction
+    for (const InputEvent& input : tickInput) {
+        heldDirections.erase(std::remove(heldDirections.begin(), heldDirections.end(), input.direction),
+                             heldDirections.end());
+        if (input.pressed) {
+            heldDirections.push_back(input.direction);
+            pacman.queueDirection(input.direction);
+        }
+    }
+
+    if (!heldDirections.empty()) {
+        pacman.queueDirection(heldDirections.back());
+    }
+
+    if (gameOver || (!stressMode && tickCount - roundStartTick <= secondsToTicks(introPauseSeconds))) {
+        updateDangerMap();
+        return;
+    }
+
+    // Check if vulnerable mode should end
+    if (vulnerableModeActive && tickCount - vulnerableStartTick > secondsToTicks(vulnerableDurationSeconds)) {
+        vulnerableModeActive = false;
+        for (Ghost& ghost : ghosts) {
+            ghost.setVulnerable(false);
+        }
+    }
+
+    // updates ghost behavior modes when time is up
+    long long modeElapsed = tickCount - modeStartTick;
+    if (currentlyScatter && modeElapsed > secondsToTicks(scatterDurationSeconds)) {
+        // switch to chase
+        currentlyScatter = false;
+        if (!resimulating) metrics.chaseMode.add();
+        modeStartTick = tickCount;
+        for (Ghost& ghost : ghosts) {
+            ghost.setMode(Ghost::Mode::CHASE);
+        }
+    } else if (!currentlyScatter && modeElapsed > secondsToTicks(chaseDurationSeconds)) {
+        // switch to scatter
+        currentlyScatter = true;
+        if (!resimulating) metrics.scatterMode.add();
+        modeStartTick = tickCount;
+        for (Ghost& ghost : ghosts) {
+            ghost.setMode(Ghost::Mode::SCATTER);
+        }
+    }
+
+    sf::Vector2i currentPacmanTile = map.getTileCoords(pacman.getPosition());
+
+    MovementDir queued = pacman.getQueuedDirection();
+    if (queued != MovementDir::STATIC && queued != pacman.getCurrentDirection()) {
+        sf::Vector2f currentPos = pacman.getPosition();
+        sf::Vector2i currentTile = map.getTileCoords(currentPos);
+
+        // A sixth of a tile either side of the centre line may turn early
+        const float corneringTolerance = tileSize / 6.0f;
+        const float halfTile = tileSize / 2.0f;
+        bool withinTolerance = false;
+
+        if (queued == MovementDir::UP || queued == MovementDir::DOWN) {
+            float tileCenterX = currentTile.x * tileSize + halfTile;
+            withinTolerance = std::abs(currentPos.x - tileCenterX) <= corneringTolerance;
+        } else if (queued == MovementDir::LEFT || queued == MovementDir::RIGHT) {
+            float tileCenterY = currentTile.y * tileSize + halfTile;
+            withinTolerance = std::abs(currentPos.y - tileCenterY) <= corneringTolerance;
+        }
+
+        if (withinTolerance) {
+            sf::Vector2i targetTile = currentTile;
+
+            switch (queued) {
+                case MovementDir::UP:
+                    targetTile.y -= 1;
+                    break;
+                case MovementDir::DOWN:
+                    targetTile.y += 1;
+                    break;
+                case MovementDir::LEFT:
+                    targetTile.x -= 1;
+                    if (targetTile.x < 0) targetTile.x = map.getWidth() - 1;
+                    break;
+                case MovementDir::RIGHT:
+                    targetTile.x += 1;
+                    if (targetTile.x >= static_cast<int>(map.getWidth())) targetTile.x = 0;
+                    break;
+                case MovementDir::STATIC:
+                    break;
+            }
+
+            if (!map.isWall(targetTile)) {
+                map.snapEntityToGrid(pacman);
+
+                switch (queued) {
+                    case MovementDir::UP:
+                        pacman.setActiveSprite("up_walking", 0);
+                        break;
+                    case MovementDir::DOWN:
+                        pacman.setActiveSprite("down_walking", 0);
+                        break;
+                    case MovementDir::LEFT:
+                        pacman.setActiveSprite("left_walking", 0);
+                        break;
+                    case MovementDir::RIGHT:
+                        pacman.setActiveSprite("right_walking", 0);
+                        break;
+                    case MovementDir::STATIC:
+                        break;
                 }
 
-                if (map.hasPellet(currentPacmanTile)) {
-                    map.eatPellet(currentPacmanTile);
-
-                    switch (map.getPelletType(currentPacmanTile)) {
-                        case PelletType::NONE:
-                            break;
-                        case PelletType::DOT:
-                            score += 10;
-                            break;
-                        case PelletType::ENERGIZER:
-                            score += 50;
-                            fright.play();
-                            // Activate vulnerable mode for all ghosts
-                            vulnerableModeActive = true;
-                            vulnerableTimer.restart();
-                            blinky.setVulnerable(true);
-                            pinky.setVulnerable(true);
-                            inky.setVulnerable(true);
-                            clyde.setVulnerable(true);
-                            break;
-                    };
-
-                    scoreText.setString(std::to_string(score));
-
-                    if (pelletSoundCount % 2) {
-                        //pellet1.play();
-                    } else {
-                        //pellet0.play();
-                    }
-
-                    pelletSoundCount++;
+                sf::Vector2f targetCenter = map.getTargetTileCenter(targetTile);
+                pacman.startMove(queued, targetCenter);
+                pacman.clearQueuedDirection();
+            }
+        }
+    }
+
+    if (!pacman.isCurrentlyMoving()) {
+        MovementDir nextDir = MovementDir::STATIC;
+
+        MovementDir queued = pacman.getQueuedDirection();
+        if (queued != MovementDir::STATIC && map.entityCanMove(pacman, queued)) {
+            nextDir = queued;
+            pacman.clearQueuedDirection();
+        }
+        else if (pacman.getCurrentDirection() != MovementDir::STATIC &&
+                 map.entityCanMove(pacman, pacman.getCurrentDirection())) {
+            nextDir = pacman.getCurrentDirection();
+        }
+
+        if (nextDir != MovementDir::STATIC) {
+            sf::Vector2i currentTile = map.getTileCoords(pacman.getPosition());
+            sf::Vector2i targetTile = currentTile;
+
+            switch (nextDir) {
+                case MovementDir::UP:
+                    targetTile.y -= 1;
+                    pacman.setActiveSprite("up_walking", 0);
+                    break;
+                case MovementDir::DOWN:
+                    targetTile.y += 1;
+                    pacman.setActiveSprite("down_walking", 0);
+                    break;
+                case MovementDir::LEFT:
+                    targetTile.x -= 1;
+                    pacman.setActiveSprite("left_walking", 0);
+                    break;
+                case MovementDir::RIGHT:
+                    targetTile.x += 1;
+                    pacman.setActiveSprite("right_walking", 0);
+                    break;
+                case MovementDir::STATIC:
+                    break;
+            }
+
+            sf::Vector2f targetCenter = map.getTargetTileCenter(targetTile);
+            pacman.startMove(nextDir, targetCenter);
+        } else {
+            pacman.setActiveSprite("static", 0);
+        }
+    }
+
+    pacman.update(map.getCentreTolerance());
+
+    //check if blinky is at an intersection
+    //if yes set target tile to pacmans tile
+    //calculate distance for all legal move options
+    //choose option with least distance for blinky to pacman
+
+
+    map.handleTunnelWrapping(pacman);
+
+    // Built once per Pac-Man tile change and shared by every chasing ghost
+    map.updatePacmanDistanceField(map.getTileCoords(pacman.getPosition()));
+
+    // One pass per type range, so the targeting is fixed for the whole inner loop
+    updateGhosts<Blinky>(ghostTypeStart[0], ghostTypeStart[1]);
+    updateGhosts<Pinky>(ghostTypeStart[1], ghostTypeStart[2]);
+    updateGhosts<Inky>(ghostTypeStart[2], ghostTypeStart[3]);
+    updateGhosts<Clyde>(ghostTypeStart[3], ghostTypeStart[4]);
+
+    updateOccupancy();
+    resolveGhostContacts();
+
+    if (map.hasPellet(currentPacmanTile)) {
+        map.eatPellet(currentPacmanTile);
+        if (!resimulating) metrics.pelletsEaten.add();
+
+        switch (map.getPelletType(currentPacmanTile)) {
+            case PelletType::NONE:
+                break;
+            case PelletType::DOT:
+                score += 10;
+                break;
+            case PelletType::ENERGIZER:
+                score += 50;
+                if (!resimulating) {
+                    if (!headless) fright->play();
+                    metrics.frightenedMode.add();
+                }
+                // Activate vulnerable mode for all ghosts
+                vulnerableModeActive = true;
+                vulnerableStartTick = tickCount;
+                ghostsEatenThisFright = 0;
+                for (Ghost& ghost : ghosts) {
+                    ghost.setVulnerable(true);
                 }
+                break;
+        };
+
+        scoreDisplay.setValue(score);
+        hudDirty = true;
+
+        if (pelletSoundCount % 2) {
+            //pellet1.play();
+        } else {
+            //pellet0.play();
+        }
+
+        pelletSoundCount++;
+
+        // Level cleared: same maze again, everyone back at the start
+        if (map.dotsRemaining() == 0) {
+            map.refillPellets();
+            staticLayerNeedsRebuild = true;
+            resetActors();
+        }
+    }
+
+    // Last, so ghosts an energizer just turned vulnerable no longer count
+    updateDangerMap();
+};
+
+void Game::onWatchedFileChanged(const std::filesystem::path& changedFile) {
+    std::error_code error;
+    auto isFile = [&](const std::filesystem::path& path) { return std::filesystem::equivalent(changedFile, path, error); };
+
+    try {
+        if (isFile(configPath)) {
+            Tuning parsed = parseTuning(loadConfig(configPath));
+
+            std::lock_guard<std::mutex> lock(reloadMutex);
+            pendingReload.tuning = std::move(parsed);
+        } else if (isFile(mazePath) || isFile(pelletPath)) {
+            bool isMaze = isFile(mazePath);
+            std::vector<int> data;
+            sf::Vector2u size;
+            if (!ResourceManager::readMapFile(changedFile, data, size)) {
+                throw std::runtime_error("Rows differ in width or the file is empty");
             }
+
+            // 1=wall, 0=path; pellets 0=none, 1=pellet, 2=power
+            int maxValue = isMaze ? 1 : 2;
+            if (std::any_of(data.begin(), data.end(), [maxValue](int value) { return value < 0 || value > maxValue; })) {
+                throw std::runtime_error("Tile values must be 0 to " + std::to_string(maxValue));
+            }
+
+            // Checked as a pair with the other file, the one waiting or else the one
+            // in play. If their sizes differ, a new maze is checked on its own and
+            // the pair waits in applyPendingReload() for the other file
+            std::lock_guard<std::mutex> lock(reloadMutex);
+            const std::optional<std::vector<int>>& pendingOther = isMaze ? pendingReload.pelletMap : pendingReload.mazeMap;
+            const std::vector<int>& other = pendingOther ? *pendingOther : isMaze ? resources->getPelletMap() : resources->getMazeMap();
+            sf::Vector2u otherSize = pendingOther ? (isMaze ? pendingReload.pelletSize : pendingReload.mazeSize)
+                                                  : resources->getMapSize(isMaze ? "pelletMap" : "mazeMap");
+            std::shared_ptr<const MazeLayout> layout;
+            if (otherSize == size) {
+                layout = MazeLayout::create(isMaze ? data : other, isMaze ? other : data, size);
+            } else if (isMaze) {
+                layout = MazeLayout::create(data, std::vector<int>(data.size(), 0), size);
+            }
+            if (layout) checkReloadedMaze(*layout);
+
+            (isMaze ? pendingReload.mazeMap : pendingReload.pelletMap) = std::move(data);
+            (isMaze ? pendingReload.mazeSize : pendingReload.pelletSize) = size;
+        } else {
+            return;
         }
+    } catch (const std::exception& e) {
+        std::cerr << "Hot-reload of " << changedFile.filename().string() << " rejected: " << e.what() << std::endl;
+        return;
+    }
 
-        window.clear();
+    reloadPending = true;
+};
 
-        window.draw(map);
-        window.draw(pacman);
-        window.draw(blinky);
-        window.draw(inky);
-        window.draw(pinky);
-        window.draw(clyde);
-        window.draw(scoreText);
-        window.draw(pacmanLifeOne);
-        window.draw(pacmanLifeTwo);
-        window.draw(fruitOne);
-        window.draw(fruitTwo);
+void Game::checkReloadedMaze(const MazeLayout& layout) {
+    const int tileCount = static_cast<int>(layout.getTileCount());
+    auto tileName = [&](int index) {
+        return "(" + std::to_string(index % layout.getWidth()) + ", " + std::to_string(index / layout.getWidth()) + ")";
+    };
+
+    int firstOpen = -1;
+    int openTiles = 0;
+    for (int i = 0; i < tileCount; ++i) {
+        if (!layout.isWall(i)) {
+            if (firstOpen < 0) firstOpen = i;
+            openTiles++;
+        } else if (layout.getPellet(i) != 0) {
+            throw std::runtime_error("Pellet on the wall at " + tileName(i));
+        }
+    }
+    if (openTiles == 0) {
+        throw std::runtime_error("The maze has no open tiles");
+    }
 
-        window.display();
+    // Flood fill from the first open tile must reach every other one
+    std::vector<bool> reached(tileCount, false);
+    std::vector<int> toVisit = {firstOpen};
+    reached[firstOpen] = true;
+    int reachedCount = 0;
+    while (!toVisit.empty()) {
+        int index = toVisit.back();
+        toVisit.pop_back();
+        reachedCount++;
+
+        for (int heading = 0; heading < 4; ++heading) {
+            int neighbour = layout.openNeighbour(index, heading);
+            if (neighbour >= 0 && !reached[neighbour]) {
+                reached[neighbour] = true;
+                toVisit.push_back(neighbour);
+            }
+        }
+    }
+
+    if (reachedCount < openTiles) {
+        int cutOff = firstOpen;
+        while (layout.isWall(cutOff) || reached[cutOff]) cutOff++;
+        throw std::runtime_error("Open tile " + tileName(cutOff) + " cannot be reached from " + tileName(firstOpen));
+    }
+};
+
+void Game::applyPendingReload() {
+    reloadPending = false;
+
+    std::lock_guard<std::mutex> lock(reloadMutex);
+
+    if (pendingReload.tuning) {
+        tuning = std::move(*pendingReload.tuning);
+        pendingReload.tuning.reset();
+
+        const float perLoopMove = tuning.perPixelMove;
+        pacman.setMovementSpeed({perLoopMove, perLoopMove});
+        for (Ghost& ghost : ghosts) {
+            ghost.setMovementSpeed({tuning.perPixelGhostMove, tuning.perPixelGhostMove});
+        }
+        std::cout << "Hot-reloaded " << configPath.filename().string()
+                  << " (frameRate and tileSize changes need a restart)" << std::endl;
+    }
+
+    if (!pendingReload.mazeMap && !pendingReload.pelletMap) return;
+
+    // A resized maze needs both files; hold one until the other matches it
+    sf::Vector2u mazeSize = pendingReload.mazeMap ? pendingReload.mazeSize : resources->getMapSize("mazeMap");
+    sf::Vector2u pelletSize = pendingReload.pelletMap ? pendingReload.pelletSize : resources->getMapSize("pelletMap");
+    if (mazeSize != pelletSize) {
+        std::cerr << "Hot-reload waiting: maze is " << mazeSize.x << "x" << mazeSize.y
+                  << " but pellets are " << pelletSize.x << "x" << pelletSize.y << std::endl;
+        return;
+    }
+
+    if (pendingReload.mazeMap) {
+        resources->setMap("mazeMap", *pendingReload.mazeMap, mazeSize);
+        pendingReload.mazeMap.reset();
+    }
+    if (pendingReload.pelletMap) {
+        resources->setMap("pelletMap", *pendingReload.pelletMap, pelletSize);
+        pendingReload.pelletMap.reset();
+    }
+
+    setupScene();
+    std::cout << "Hot-reloaded the maze (" << mazeSize.x << "x" << mazeSize.y << "), round restarted" << std::endl;
+};
+
+void Game::updateDangerMap() {
+    dangerSources.clear();
+
+    for (std::size_t i = 0; i < ghosts.size(); ++i) {
+        const Ghost& ghost = ghosts[i];
+        if (ghost.getIsVulnerable()) continue;
+
+        // A move takes ceil(tile / speed) ticks, plus the tick spent stopping at the tile centre
+        float speed = std::max(ghost.getMovementSpeed().x, 0.01f);
+        unsigned int ticksPerTile = static_cast<unsigned int>(std::ceil(map.getTileSize() / speed)) + 1;
+        long long delay = std::max(0LL, ghostReleaseTicks[i] + 1 - tickCount);
+
+        dangerSources.push_back({map.getTileCoords(ghost.getPosition()), ghost.getCurrentDirection(),
+                                 ticksPerTile, static_cast<unsigned int>(delay)});
+    }
+
+    dangerMapStale = true;
+};
+
+const DangerMap& Game::getDangerMap() const {
+    if (dangerMapStale) {
+        dangerMap.compute(map, dangerSources);
+        dangerMapStale = false;
+    }
+
+    return dangerMap;
+};
+
+void Game::updateOccupancy() {
+    pacman.updateOccupiedTile(map.getTileCoords(pacman.getPosition()));
+
+    for (Ghost& ghost : ghosts) {
+        ghost.updateOccupiedTile(map.getTileCoords(ghost.getPosition()));
+    }
+};
+
+void Game::resolveGhostContacts() {
+    const float tileSize = static_cast<float>(map.getTileSize());
+    // Centres within half a tile of each other on both axes touch
+    const float contactDistance = tileSize / 2.0f;
+
+    // An entity moves along one straight segment of at most a tile per tick; a
+    // longer jump is a tunnel wrap or respawn and only counts where it landed
+    const auto sweepStart = [tileSize](const Entity& entity) {
+        sf::Vector2f start = entity.getPreviousPosition();
+        sf::Vector2f step = entity.getPosition() - start;
+        return (std::abs(step.x) > tileSize || std::abs(step.y) > tileSize) ? entity.getPosition() : start;
+    };
+
+    const sf::Vector2f pacmanStart = sweepStart(pacman);
+    const sf::Vector2f pacmanEnd = pacman.getPosition();
+
+    // Broad phase: a ghost that touches Pac-Man's path ends the tick within two
+    // tiles of it, so only those occupancy buckets are searched
+    sf::Vector2i firstTile = map.getTileCoords({std::min(pacmanStart.x, pacmanEnd.x), std::min(pacmanStart.y, pacmanEnd.y)});
+    sf::Vector2i lastTile = map.getTileCoords({std::max(pacmanStart.x, pacmanEnd.x), std::max(pacmanStart.y, pacmanEnd.y)});
+    firstTile = {firstTile.x - 2, std::max(firstTile.y - 2, 0)};
+    lastTile = {std::min(lastTile.x + 2, firstTile.x + static_cast<int>(map.getWidth()) - 1),
+                std::min(lastTile.y + 2, static_cast<int>(map.getHeight()) - 1)};
+
+    struct Contact {
+        float time;
+        unsigned int slot;
+    };
+    std::vector<Contact> contacts;
+
+    for (int y = firstTile.y; y <= lastTile.y; ++y) {
+        for (int x = firstTile.x; x <= lastTile.x; ++x) {
+            occupancy.forEachInTile({x, y}, [&](unsigned int slot) {
+                if (slot == 0) return;
+
+                const Ghost& ghost = ghosts[slot - 1];
+                std::optional<float> time = sweptContactTime(pacmanStart, pacmanEnd, sweepStart(ghost), ghost.getPosition(), contactDistance);
+                if (time) {
+                    contacts.push_back({*time, slot});
+                }
+            });
+        }
+    }
+
+    // In the order they happened within the tick: eating a ghost on the way into
+    // another one still scores before Pac-Man is caught
+    std::sort(contacts.begin(), contacts.end(), [](const Contact& a, const Contact& b) {
+        return a.time != b.time ? a.time < b.time : a.slot < b.slot;
+    });
+
+    bool caught = false;
+    for (const Contact& contact : contacts) {
+        Ghost& ghost = ghosts[contact.slot - 1];
+        if (!ghost.getIsVulnerable()) {
+            caught = true;
+            break;
+        }
+
+        // Each further ghost eaten on the same energizer is worth more
+        std::size_t chainIndex = std::min<std::size_t>(ghostsEatenThisFright, tuning.ghostEatenPoints.size() - 1);
+        score += tuning.ghostEatenPoints[chainIndex];
+        ghostsEatenThisFright++;
+        scoreDisplay.setValue(score);
+        hudDirty = true;
+        if (!resimulating && !headless) eatGhost->play();
+
+        ghost.returnHome();
+        ghost.updateOccupiedTile(map.getTileCoords(ghost.getPosition()));
+    }
+
+    if (!caught || stressMode) return;
+
+    if (livesRemaining == 0) {
+        gameOver = true;
+        pacman.setActiveSprite("death", 10);
+        return;
+    }
+
+    livesRemaining--;
+    hudDirty = true;
+    resetActors();
+};
+
+void Game::resetActors() {
+    pacman.teleport(pacmanStartPosition);
+    pacman.setActiveSprite("static", 0);
+
+    for (Ghost& ghost : ghosts) {
+        ghost.returnHome();
+    }
+
+    vulnerableModeActive = false;
+    roundStartTick = tickCount;
+    updateOccupancy();
+};
+
+void Game::saveSnapshot(Snapshot& snapshot) const {
+    snapshot.pacman = pacman;
+    snapshot.ghosts = ghosts;
+    snapshot.occupancy = occupancy;
+    snapshot.eatenPellets = map.getEatenPellets();
+    snapshot.tickCount = tickCount;
+    snapshot.modeStartTick = modeStartTick;
+    snapshot.currentlyScatter = currentlyScatter;
+    snapshot.vulnerableModeActive = vulnerableModeActive;
+    snapshot.vulnerableStartTick = vulnerableStartTick;
+    snapshot.ghostsEatenThisFright = ghostsEatenThisFright;
+    snapshot.roundStartTick = roundStartTick;
+    snapshot.livesRemaining = livesRemaining;
+    snapshot.gameOver = gameOver;
+    snapshot.heldDirections = heldDirections;
+    snapshot.pelletSoundCount = pelletSoundCount;
+    snapshot.score = score;
+};
+
+void Game::loadSnapshot(const Snapshot& snapshot) {
+    pacman = snapshot.pacman;
+    ghosts = snapshot.ghosts;
+    occupancy = snapshot.occupancy;
+    map.restoreEatenPellets(snapshot.eatenPellets);
+    tickCount = snapshot.tickCount;
+    modeStartTick = snapshot.modeStartTick;
+    currentlyScatter = snapshot.currentlyScatter;
+    vulnerableModeActive = snapshot.vulnerableModeActive;
+    vulnerableStartTick = snapshot.vulnerableStartTick;
+    ghostsEatenThisFright = snapshot.ghostsEatenThisFright;
+    roundStartTick = snapshot.roundStartTick;
+    heldDirections = snapshot.heldDirections;
+    pelletSoundCount = snapshot.pelletSoundCount;
+    gameOver = snapshot.gameOver;
+
+    if (livesRemaining != snapshot.livesRemaining || score != snapshot.score) {
+        livesRemaining = snapshot.livesRemaining;
+        score = snapshot.score;
+        scoreDisplay.setValue(score);
+        hudDirty = true;
     }
 
+    updateDangerMap();
+};
+
+void Game::setInterpolationAlpha(float alpha) {
+    pacman.setInterpolationAlpha(alpha);
+    for (Ghost& ghost : ghosts) {
+        ghost.setInterpolationAlpha(alpha);
+    }
 };
+
+void Game::paceFrame(const sf::Clock& frameClock, sf::Time nextTickDue, bool windowFocused) {
+    // sf::sleep overshoots by up to a scheduler quantum, so stop sleeping this
+    // far ahead of the deadline and spin for the rest
+    const sf::Time spinMargin = sf::milliseconds(2);
+    const sf::Time unfocusedSleep = sf::milliseconds(100);
+
+    switch (pacingMode) {
+        case PacingMode::UNLIMITED:
+        case PacingMode::VSYNC:
+            return;
+        case PacingMode::LOW_POWER:
+            if (!windowFocused) {
+                sf::sleep(unfocusedSleep);
+                return;
+            }
+            break;
+        case PacingMode::HYBRID:
+            break;
+    }
+
+    sf::Time remaining = nextTickDue - frameClock.getElapsedTime();
+    if (remaining > spinMargin) {
+        sf::sleep(remaining - spinMargin);
+    }
+
+    while (frameClock.getElapsedTime() < nextTickDue) {
+    }
+};
+
+template <typename Targeting>
+void Game::updateGhosts(std::size_t first, std::size_t last) {
+    for (std::size_t i = first; i < last; ++i) {
+        if (tickCount <= ghostReleaseTicks[i]) continue;
+
+        Ghost& ghost = ghosts[i];
+        ghost.updateAI<Targeting>(map, pacman);
+        ghost.update(map.getCentreTolerance());
+        map.handleTunnelWrapping(ghost);
+    }
+}
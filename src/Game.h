@@ -1,34 +1,398 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include <SFML/Audio/Sound.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Time.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <array>
+#include <atomic>
+#include <cmath>
 #include <string>
 #include <filesystem>
+#include <mutex>
+#include <memory>
+#include <optional>
+#include <vector>
 #include <nlohmann/json.hpp>
 
+#include "DangerMap.h"
+#include "DigitAtlas.h"
+#include "GameMetrics.h"
+#include "Ghost.h"
+#include "HudNumber.h"
+#include "InputQueue.h"
+#include "MazeGenerator.h"
+#include "MazeMap.h"
+#include "OccupancyGrid.h"
+#include "Pacman.h"
+#include "ResourceManager.h"
+#include "SoftwareRenderer.h"
+
 using json = nlohmann::json;
 
 class Game {
 public:
+    enum class PacingMode {
+        UNLIMITED,  // Redraw as fast as possible
+        VSYNC,      // Block in display() on the monitor refresh
+        HYBRID,     // Sleep, then spin up to the next simulation tick
+        LOW_POWER   // HYBRID while focused, long sleeps while unfocused
+    };
+
+    // The config.json values that can be swapped in while the game runs
+    struct Tuning {
+        float perPixelMove;
+        float perPixelGhostMove;  // pixels per tick, from a speed given in tiles so it follows tileSize
+        std::vector<int> ghostEatenPoints;  // per ghost eaten on one energizer
+    };
+
     Game(const std::filesystem::path& configPath);
     
-    void setScaleFactor(int newScaleFactor) { scaleFactor = newScaleFactor; }
+    // Only resizes the window, so it can change while the game runs
+    void setScaleFactor(int newScaleFactor) {
+        scaleFactor = newScaleFactor;
+        scaleFactorChanged = true;
+    }
+
+    void setPacingMode(PacingMode newPacingMode) { pacingMode = newPacingMode; }
+
+    // Prints frame-interval mean, p99 and jitter every 10 seconds
+    void setReportFramePacing(bool enabled) { reportFramePacing = enabled; }
+
+    // Prints input-to-tick and input-to-present latency every 10 seconds
+    void setMeasureInputLatency(bool enabled) { measureInputLatency = enabled; }
 
     void run();
 
+    // Maze collision and pellet files, in the assets/game/maze.txt format. Mazes
+    // larger than the 28x31 playfield scroll with Pac-Man
+    void setMazePaths(const std::filesystem::path& newMazePath, const std::filesystem::path& newPelletPath) {
+        mazePath = newMazePath;
+        pelletPath = newPelletPath;
+    }
+
+    // Packed assets to load from before falling back to the files under assets/;
+    // built by the packer target. An empty path uses the loose files only.
+    void setAssetPack(const std::filesystem::path& packPath) { assetPackPath = packPath; }
+
+    // Plays a MazeGenerator maze instead of the maze files
+    void setGeneratedMaze(const MazeGenerator::Settings& settings, std::uint64_t seed) {
+        generatedMazeSettings = settings;
+        generatedMazeSeed = seed;
+    }
+
+    // Watches config.json and the maze files during run(). Changes are parsed and
+    // checked off the main thread and swapped in between ticks; a new maze restarts
+    // the round on it, new tuning applies in place
+    void setHotReload(bool enabled) { hotReload = enabled; }
+
+    // Has run() publish tick rate, frame and catch-up times, score, pellets,
+    // ghost-mode changes and asset load time to settings.path every interval,
+    // written from a background thread
+    void setMetricsExport(const GameMetrics::ExportSettings& settings) { metricsExport = settings; }
+
+    // Saves the inputs of the next run() to replayPath when the window closes
+    void setRecordPath(const std::filesystem::path& replayPath) { recordPath = replayPath; }
+
+    // How soon any non-vulnerable ghost can reach each tile from where the ghosts
+    // stood at the end of the last tick. Computed on the first call after a tick,
+    // so ticks nobody asks about cost nothing.
+    const DangerMap& getDangerMap() const;
+
+    // The rest is for modes that load, step and draw the game themselves
+    // instead of calling run(): captures, fuzzing, observation, benchmarks and versus
+
+    // No window and no sounds. With software set, setupScene() makes no GPU
+    // resources either and the scene is drawn with drawSceneSoftware().
+    // Call before loadResources()
+    void setHeadless(bool software) {
+        headless = true;
+        softwareRendering = software;
+    }
+
+    // Loads the assets that do not depend on the scale factor
+    void loadResources();
+
+    // Plays on the assets and maze layout another game has loaded instead, set up
+    // the way it is, so many headless instances keep one copy; takes the place
+    // of loadResources()
+    void shareResources(const Game& loaded);
+    bool usesSharedResources() const { return sharesResources; }
+
+    // (Re)builds the atlas, maze, entities and HUD for the current scale factor
+    void setupScene();
+
+    // Advances the simulation by one fixed timestep, applying the key events
+    // that arrived during it
+    void tick(const std::vector<InputEvent>& tickInput);
+
+    // Everything tick() changes, so rollback can rewind the simulation
+    struct Snapshot {
+        Pacman pacman;
+        std::vector<Ghost> ghosts;
+        OccupancyGrid occupancy;
+        MazeMap::PelletBits eatenPellets;
+        long long tickCount;
+        long long modeStartTick;
+        bool currentlyScatter;
+        bool vulnerableModeActive;
+        long long vulnerableStartTick;
+        int ghostsEatenThisFright;
+        long long roundStartTick;
+        int livesRemaining;
+        bool gameOver;
+        std::vector<MovementDir> heldDirections;
+        int pelletSoundCount;
+        int score;
+    };
+
+    void saveSnapshot(Snapshot& snapshot) const;
+    void loadSnapshot(const Snapshot& snapshot);
+
+    // No intro pause, and Pac-Man cannot be caught
+    void setStressMode(bool enabled) { stressMode = enabled; }
+
+    // Re-running ticks after a rollback, so no sounds or metrics
+    void setResimulating(bool enabled) { resimulating = enabled; }
+
+    // Hands Blinky to a second player, whose direction is set before each tick.
+    // setupScene() builds new ghosts, so call it after that
+    void setGhostPlayerControlled(bool enabled) { ghosts.front().setPlayerControlled(enabled); }
+    void setGhostPlayerInput(MovementDir direction) { ghosts.front().setRequestedDirection(direction); }
+
+    // Replaces the ghosts setupScene() made with count copies of them, cycling
+    // through aiTypes, released at once and spread evenly over the open tiles
+    void spawnGhosts(std::size_t count, const std::vector<Ghost::AIType>& aiTypes);
+
+    // Takes a pellet off the maze without scoring it, to set a scene up
+    void removePellet(sf::Vector2i tile) { map.eatPellet(tile); }
+
+    // Blend factor between the previous and current tick positions of every entity
+    void setInterpolationAlpha(float alpha);
+
+    // Returns the number of draw calls issued
+    unsigned int drawScene(sf::RenderTarget& target);
+
+    // drawScene() into sceneLayer at base resolution, then one draw of it onto
+    // target at the largest whole scale that fits, centred. The scene costs the
+    // same at any window size.
+    unsigned int presentScene(sf::RenderTarget& target);
+
+    // drawScene() on the CPU, for a scene set up with setHeadless(true)
+    void drawSceneSoftware(SoftwareRenderer& renderer);
+
+    // Blocks until the next frame should start according to pacingMode
+    void paceFrame(const sf::Clock& frameClock, sf::Time nextTickDue, bool windowFocused);
+
+    void setStaticLayerCache(bool enabled) { useStaticLayerCache = enabled; }
+    bool getStaticLayerCache() const { return useStaticLayerCache; }
+
+    static constexpr int supportedScaleFactors[] = {1, 2, 3, 4};
+
+    const std::filesystem::path& getConfigPath() const { return configPath; }
+    const Tuning& getTuning() const { return tuning; }
+    float getFramerate() const { return framerate; }
+    int getBaseTileSize() const { return baseTileSize; }
+    int getScaleFactor() const { return scaleFactor; }
+    PacingMode getPacingMode() const { return pacingMode; }
+    const std::string& getWindowName() const { return windowName; }
+
+    sf::Vector2u getBaseResolution() const { return baseWindowRes; }
+    sf::Vector2u getWindowResolution() const { return baseWindowRes * static_cast<unsigned int>(scaleFactor); }
+
+    // The maze area of the scene in base pixels; the HUD sits below it
+    sf::Vector2u getPlayfieldSize() const { return playfieldTiles * static_cast<unsigned int>(baseTileSize); }
+
+    // The texture atlas as a CPU image, loaded when the game is headless and software
+    const sf::Image& getAtlasImage() { return resources->getImage("all_textures"); }
+
+    const MazeMap& getMap() const { return map; }
+    const Pacman& getPacman() const { return pacman; }
+    const std::vector<Ghost>& getGhosts() const { return ghosts; }
+    long long getTickCount() const { return tickCount; }
+    int getScore() const { return score; }
+    bool isGameOver() const { return gameOver; }
+
+    // Where setupScene() sends ghosts out of the house; the house lies below it
+    sf::Vector2i getGhostBoxExitTile() const { return ghostBoxExitTile; }
+
 private:
     json loadConfig(const std::filesystem::path& configPath);
 
+    // Throws std::runtime_error if a value is missing or out of range
+    static Tuning parseTuning(const json& config);
+
+    // Hot-reload, on the watcher thread: parses and checks the changed file,
+    // then queues it for applyPendingReload()
+    void onWatchedFileChanged(const std::filesystem::path& changedFile);
+
+    // Hot-reload: throws std::runtime_error unless the maze has open tiles, all
+    // reachable from each other (tunnels wrap), and every pellet is on one
+    static void checkReloadedMaze(const MazeLayout& layout);
+
+    // Hot-reload, between ticks: swaps in whatever the watcher queued
+    void applyPendingReload();
+
+    // Sound players for the loaded buffers
+    void createSounds();
+
+    // Moves every entity's occupancy entry to the tile it ended the tick in
+    void updateOccupancy();
+
+    // Sweeps Pac-Man and nearby ghosts along their motion this tick: Pac-Man eats
+    // the vulnerable ghosts he meets and is caught by any other, earliest first
+    void resolveGhostContacts();
+
+    // Collects the ghosts that could catch Pac-Man; the danger map itself is
+    // only recomputed from them when someone asks for it
+    void updateDangerMap();
+
+    // Puts Pac-Man and the ghosts back at their start positions after Pac-Man is caught
+    void resetActors();
+
+    // AI, movement and tunnel wrap for ghosts first .. last - 1, all of Targeting's type
+    template <typename Targeting>
+    void updateGhosts(std::size_t first, std::size_t last);
+
+    long long secondsToTicks(float seconds) const { return std::lround(seconds * framerate); }
+
+    unsigned int drawHud(sf::RenderTarget& target);
+
+    // Follows Pac-Man, clamped so the camera never shows past the maze edges
+    void updateCamera();
+
+    // Mazes that fit the playfield are drawn unscrolled and can use the static layer
+    bool mazeFitsPlayfield() const { return map.getWidth() <= playfieldTiles.x && map.getHeight() <= playfieldTiles.y; }
+
+    // Maps a tile of the classic 28x31 layout to the nearest open tile at the
+    // same relative spot in the loaded maze
+    sf::Vector2i mapClassicTile(sf::Vector2f classicTile) const;
+
+    // Brings staticLayer up to date: a full redraw after setupScene(), otherwise
+    // only the dirty maze tiles and, if the score changed, the HUD strip
+    unsigned int updateStaticLayer();
+
+    const std::filesystem::path configPath;
     const json config;
 
+    // Fixed for the life of the Game; tuning may be hot-reloaded
     const float framerate;
-    const float perPixelMove;
     const int baseTileSize;
+    Tuning tuning;
 
     int scaleFactor = 3;
+    bool scaleFactorChanged = false;  // run() resizes its window to match
+
+    PacingMode pacingMode = PacingMode::HYBRID;
+
+    bool reportFramePacing = false;
+    bool measureInputLatency = false;
 
-    sf::Vector2u windowRes = {672, 810};
+    bool hotReload = false;
+
+    // Parsed by the watcher thread, waiting for the next tick boundary
+    struct PendingReload {
+        std::optional<Tuning> tuning;
+        std::optional<std::vector<int>> mazeMap;
+        std::optional<std::vector<int>> pelletMap;
+        sf::Vector2u mazeSize;
+        sf::Vector2u pelletSize;
+    };
+    std::mutex reloadMutex;
+    PendingReload pendingReload;  // guarded by reloadMutex
+    std::atomic<bool> reloadPending{false};
+
+    std::filesystem::path recordPath;
+
+    std::optional<GameMetrics::ExportSettings> metricsExport;
+
+    // Updated by run() and tick(), exported while run() plays
+    GameMetrics metrics;
+
+    std::filesystem::path assetPackPath = "assets.pack";
+    std::filesystem::path mazePath = "assets/game/maze.txt";
+    std::filesystem::path pelletPath = "assets/game/pellets.txt";
+
+    std::optional<MazeGenerator::Settings> generatedMazeSettings;
+    std::uint64_t generatedMazeSeed = 0;
+    std::optional<GeneratedMaze> generatedMaze;  // its house and start tiles place the actors
+    sf::Vector2i ghostBoxExitTile;               // where setupScene() sends ghosts out of the house
+
+    sf::Vector2u baseWindowRes = {224, 270};
+    // Maze area of the window in tiles; the HUD sits below it
+    sf::Vector2u playfieldTiles = {28, 31};
     std::string windowName = "Pacmen";
+
+    // Shared with the games set up by shareResources(), which only read from it
+    std::shared_ptr<ResourceManager> resources = std::make_shared<ResourceManager>();
+    bool sharesResources = false;
+    MazeMap map;
+    sf::View camera;
+
+    Pacman pacman;
+    sf::Vector2f pacmanStartPosition;
+
+    // Blinky, Pinky, Inky and Clyde in play; any number in stress mode. Updated
+    // one type range at a time; each ghost moves once tickCount passes its release tick
+    std::vector<Ghost> ghosts;
+    std::vector<long long> ghostReleaseTicks;
+
+    // Ghosts are kept grouped by AIType in enum order: type t is
+    // ghosts[ghostTypeStart[t] .. ghostTypeStart[t + 1] - 1]
+    std::array<std::size_t, 5> ghostTypeStart = {0, 0, 0, 0, 0};
+
+    // Slot 0 is Pac-Man, ghost i is slot i + 1
+    OccupancyGrid occupancy;
+
+    mutable DangerMap dangerMap;
+    mutable std::vector<DangerMap::Source> dangerSources;
+    mutable bool dangerMapStale = false;
+
+    // Simulation state advanced by tick()
+    long long tickCount = 0;
+    long long modeStartTick = 0;
+    bool currentlyScatter = true;
+    bool vulnerableModeActive = false;
+    long long vulnerableStartTick = 0;
+    int ghostsEatenThisFright = 0;
+    long long roundStartTick = 0;  // the intro pause restarts after Pac-Man is caught
+    int livesRemaining = 2;
+    bool gameOver = false;
+    bool stressMode = false;  // no intro pause, and Pac-Man cannot be caught
+    bool resimulating = false;  // re-running ticks after a rollback, so no sounds or metrics
+    bool headless = false;      // no window, so no sounds
+    bool softwareRendering = false;  // setupScene() makes no GPU resources; draw with drawSceneSoftware()
+    std::vector<MovementDir> heldDirections;  // most recent press last
+    int pelletSoundCount = 0;
+
+    std::optional<sf::Sound> pellet0;
+    std::optional<sf::Sound> pellet1;
+    std::optional<sf::Sound> fright;
+    std::optional<sf::Sound> eatGhost;
+
+    int score = 0;
+    std::optional<DigitAtlas> digitAtlas;
+    HudNumber scoreDisplay;
+    std::optional<sf::Sprite> pacmanLifeOne;
+    std::optional<sf::Sprite> pacmanLifeTwo;
+    std::optional<sf::Sprite> fruitOne;
+    std::optional<sf::Sprite> fruitTwo;
+
+    // Maze, pellets and HUD pre-composited into one texture. Eaten pellets and
+    // score changes repaint only what changed; entities are drawn on top.
+    bool useStaticLayerCache = true;
+    std::optional<sf::RenderTexture> staticLayer;
+    std::optional<sf::Sprite> staticLayerSprite;
+
+    // The whole scene at base resolution, upscaled by presentScene()
+    std::optional<sf::RenderTexture> sceneLayer;
+    std::optional<sf::Sprite> sceneLayerSprite;
+    bool staticLayerNeedsRebuild = true;
+    bool hudDirty = false;
 };
 
 #endif
@@ -0,0 +1,20 @@
+#include "GameMetrics.h"
+
+void GameMetrics::startExport(const ExportSettings& settings) {
+    exporter.reset();
+    exporter = std::make_unique<MetricsExporter>(registry, settings.path, settings.format, settings.interval);
+}
+
+void GameMetrics::recordFrame(sf::Time elapsed, int ticksRun, int currentScore) {
+    frameTime.observe(elapsed.asSeconds());
+    catchUpTicks.observe(ticksRun);
+    score.set(currentScore);
+
+    tickRateTicks += ticksRun;
+    tickRateElapsed += elapsed;
+    if (tickRateElapsed >= sf::seconds(1.0f)) {
+        tickRate.set(tickRateTicks / tickRateElapsed.asSeconds());
+        tickRateTicks = 0;
+        tickRateElapsed = sf::Time::Zero;
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef GAMEMETRICS_H
+#define GAMEMETRICS_H
+
+#include <SFML/System/Time.hpp>
+#include <filesystem>
+#include <memory>
+
+#include "Metrics.h"
+#include "MetricsExporter.h"
+
+// What a game publishes while it plays: tick rate, frame and catch-up times,
+// score, pellets, ghost-mode changes and asset load time. The game loop
+// updates them without locks; startExport() has a MetricsExporter write them
+// to a file from a background thread.
+class GameMetrics {
+private:
+    // Ahead of the series below, which register in it as they are constructed
+    Metrics registry;
+
+public:
+    struct ExportSettings {
+        std::filesystem::path path;
+        MetricsExporter::Format format = MetricsExporter::Format::PROMETHEUS;
+        sf::Time interval = sf::seconds(10.0f);
+    };
+
+    // Writes a snapshot every settings.interval until stopExport(); throws if
+    // the first one cannot be written
+    void startExport(const ExportSettings& settings);
+
+    // Writes one last snapshot and stops the exporter's thread
+    void stopExport() { exporter.reset(); }
+
+    // Once per frame, with the time since the last one and the ticks it ran;
+    // the tick rate is updated once a second
+    void recordFrame(sf::Time elapsed, int ticksRun, int currentScore);
+
+    Metrics::Counter& ticks = registry.addCounter("pacman_ticks_total", "Simulation ticks run");
+    Metrics::Gauge& tickRate = registry.addGauge("pacman_ticks_per_second", "Simulation ticks run in the last second");
+    Metrics::Histogram& frameTime = registry.addHistogram("pacman_frame_time_seconds", "Time between frames",
+                                                          {0.004, 0.008, 0.0125, 0.0167, 0.02, 0.025, 0.0333, 0.05, 0.1});
+    Metrics::Histogram& catchUpTicks = registry.addHistogram("pacman_catch_up_ticks", "Simulation ticks run per frame", {0, 1, 2, 3, 4, 5});
+    Metrics::Gauge& score = registry.addGauge("pacman_score", "Current score");
+    Metrics::Counter& pelletsEaten = registry.addCounter("pacman_pellets_eaten_total", "Dots and energizers eaten");
+    Metrics::Counter& scatterMode = registry.addCounter("pacman_ghost_mode_transitions_total", "Ghost mode changes by new mode", "mode=\"scatter\"");
+    Metrics::Counter& chaseMode = registry.addCounter("pacman_ghost_mode_transitions_total", "Ghost mode changes by new mode", "mode=\"chase\"");
+    Metrics::Counter& frightenedMode = registry.addCounter("pacman_ghost_mode_transitions_total", "Ghost mode changes by new mode", "mode=\"frightened\"");
+    Metrics::Gauge& assetLoad = registry.addGauge("pacman_asset_load_seconds", "Time to load resources and set up the scene");
+
+private:
+    std::unique_ptr<MetricsExporter> exporter;
+
+    // Ticks run since the tick-rate gauge was last set
+    int tickRateTicks = 0;
+    sf::Time tickRateElapsed;
+};
+
+#endif
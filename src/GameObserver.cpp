@@ -0,0 +1,38 @@
+#include "GameObserver.h"
+#include "Game.h"
+#include <stdexcept>
+
+GameObserver::GameObserver(Game& game, const Settings& settings, std::uint8_t* stackMemory) :
+    game(game),
+    renderer(getPlayfieldSize(game)),
+    encoder(getPlayfieldSize(game), settings.size, settings.format),
+    stack(stackMemory, encoder.getFrameBytes(), settings.stackDepth)
+{
+    if (settings.stackDepth == 0) {
+        throw std::runtime_error("Observations need at least one stacked frame");
+    }
+
+    game.setHeadless(true);
+    if (!game.usesSharedResources()) game.loadResources();
+    game.setupScene();
+
+    renderer.setAtlas(game.getAtlasImage());
+
+    pushFrame();
+    stack.fillWithNewest();
+}
+
+sf::Vector2u GameObserver::getPlayfieldSize(const Game& game) {
+    return game.getPlayfieldSize();
+}
+
+void GameObserver::step(const std::vector<InputEvent>& tickInput) {
+    game.tick(tickInput);
+    pushFrame();
+}
+
+void GameObserver::pushFrame() {
+    game.drawSceneSoftware(renderer);
+    encoder.encode(renderer.getPixels(), stack.nextFrame());
+    stack.push();
+}
@@ -0,0 +1,54 @@
+#ifndef GAMEOBSERVER_H
+#define GAMEOBSERVER_H
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "FrameStack.h"
+#include "InputQueue.h"
+#include "ObservationEncoder.h"
+#include "SoftwareRenderer.h"
+
+class Game;
+
+// Steps a game for a vision agent, headless and GPU-free: the playfield is
+// drawn by a SoftwareRenderer at base resolution (8-pixel tiles), then
+// downsampled and converted into a stack of recent frames
+class GameObserver {
+public:
+    struct Settings {
+        sf::Vector2u size = {84, 84};   // {224, 248} keeps every playfield pixel
+        ObservationEncoder::Format format = ObservationEncoder::Format::GRAYSCALE;
+        unsigned int stackDepth = 4;    // frames per observation, newest replacing oldest
+    };
+
+    static std::size_t getObservationBytes(const Settings& settings) {
+        return static_cast<std::size_t>(settings.size.x) * settings.size.y * settings.stackDepth;
+    }
+
+    // Sets the game up to be observed. The frame stack lives in stackMemory,
+    // which holds getObservationBytes(settings) bytes and must outlive the
+    // observer; it starts filled with the first frame
+    GameObserver(Game& game, const Settings& settings, std::uint8_t* stackMemory);
+
+    // Runs one tick on tickInput and pushes the frame it ends on
+    void step(const std::vector<InputEvent>& tickInput);
+
+    const FrameStack& getStack() const { return stack; }
+
+private:
+    // Only the playfield is observed; the HUD below it is clipped away
+    static sf::Vector2u getPlayfieldSize(const Game& game);
+
+    // Draws, encodes and pushes one frame
+    void pushFrame();
+
+    Game& game;
+    SoftwareRenderer renderer;
+    ObservationEncoder encoder;
+    FrameStack stack;
+};
+
+#endif
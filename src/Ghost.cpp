@@ -1,7 +1,13 @@
 #include "Ghost.h"
+#include "Blinky.h"
+#include "Clyde.h"
+#include "Inky.h"
 #include "MazeMap.h"
 #include "Pacman.h"
+#include "Pinky.h"
+#include <algorithm>
 #include <cmath>
+#include <iterator>
 #include <SFML/System/Clock.hpp>
 
 static MovementDir oppositeDirection(MovementDir d) {
@@ -15,13 +21,29 @@ static MovementDir oppositeDirection(MovementDir d) {
 	return MovementDir::STATIC;
 }
 
-	void Ghost::updateAI(MazeMap& map, const Pacman& pacman) {
+template <typename Targeting>
+void Ghost::updateAI(MazeMap& map, const Pacman& pacman) {
 	// Only decide a new move when the ghost is not currently moving
 	if (isCurrentlyMoving()) return;
 
 	sf::Vector2i currentTile = map.getTileCoords(getPosition());
 
+	if (playerControlled) {
+		// Versus mode: turn as requested when open, otherwise carry on, otherwise wait
+		for (MovementDir dir : {requestedDirection, lastDirection}) {
+			if (dir == MovementDir::STATIC) continue;
+			if (isHouseDoorTile(currentTile) && dir == MovementDir::DOWN) continue;
+
+			if (map.entityCanMove(*this, dir)) {
+				moveToNeighbour(map, currentTile, dir);
+				return;
+			}
+		}
+		return;
+	}
+
 	sf::Vector2i targetTile;
+	bool followPacmanField = false;  // chasing Pac-Man himself rather than a tile near him
 	
 	// If ghost hasn't exited the box yet, force it to target the exit
 	if (!hasExitedBox) {
@@ -50,90 +72,44 @@ static MovementDir oppositeDirection(MovementDir d) {
 				targetTile.y = 0;  // Far top
 			}
 		} else if (currentMode == Mode::CHASE) {
-			// Normal chase/scatter AI
+			// Each ghost's own chase target, resolved at compile time
 			sf::Vector2i pacmanTile = map.getTileCoords(pacman.getPosition());
-			
-			if (aiType == AIType::BLINKY) {
-				// Blinky: direct chase to Pacman
-				targetTile = pacmanTile;
-			} else if (aiType == AIType::PINKY) {
-				// Pinky: ambush 4 tiles ahead of Pacman
-				MovementDir pacmanDir = pacman.getCurrentDirection();
-				targetTile = pacmanTile;
-				
-				// Look 4 tiles ahead in Pacman's direction of travel
-				for (int i = 0; i < 4; i++) {
-					switch (pacmanDir) {
-						case MovementDir::UP:
-							targetTile.y -= 1;
-							if (targetTile.y < 0) targetTile.y = static_cast<int>(map.getHeight()) - 1;
-							break;
-						case MovementDir::DOWN:
-							targetTile.y += 1;
-							if (targetTile.y >= static_cast<int>(map.getHeight())) targetTile.y = 0;
-							break;
-						case MovementDir::LEFT:
-							targetTile.x -= 1;
-							if (targetTile.x < 0) targetTile.x = static_cast<int>(map.getWidth()) - 1;
-							break;
-						case MovementDir::RIGHT:
-							targetTile.x += 1;
-							if (targetTile.x >= static_cast<int>(map.getWidth())) targetTile.x = 0;
-							break;
-						case MovementDir::STATIC:
-							break;
-					}
-				}
-			} else if (aiType == AIType::INKY) {
-				// Inky: targets 2 tiles ahead of Pacman
-				MovementDir pacmanDir = pacman.getCurrentDirection();
-				targetTile = pacmanTile;
-				
-				// Look 2 tiles ahead in Pacman's direction of travel
-				for (int i = 0; i < 2; i++) {
-					switch (pacmanDir) {
-						case MovementDir::UP:
-							targetTile.y -= 1;
-							if (targetTile.y < 0) targetTile.y = static_cast<int>(map.getHeight()) - 1;
-							break;
-						case MovementDir::DOWN:
-							targetTile.y += 1;
-							if (targetTile.y >= static_cast<int>(map.getHeight())) targetTile.y = 0;
-							break;
-						case MovementDir::LEFT:
-							targetTile.x -= 1;
-							if (targetTile.x < 0) targetTile.x = static_cast<int>(map.getWidth()) - 1;
-							break;
-						case MovementDir::RIGHT:
-							targetTile.x += 1;
-							if (targetTile.x >= static_cast<int>(map.getWidth())) targetTile.x = 0;
-							break;
-						case MovementDir::STATIC:
-							break;
-					}
-				}
-			} else {
-				// Clyde: direct chase to Pacman
-				targetTile = pacmanTile;
-			}
+			targetTile = Targeting::chaseTarget(map, pacmanTile, pacman.getCurrentDirection());
+			followPacmanField = Targeting::followsPacmanField;
 		} else {
 			// Scatter: each ghost goes to their corner
-			if (aiType == AIType::BLINKY) {
-				// Blinky: top-right corner
-				targetTile = {static_cast<int>(map.getWidth()) - 1, 0};
-			} else if (aiType == AIType::PINKY) {
-				// Pinky: top-left corner
-				targetTile = {0, 0};
-			} else if (aiType == AIType::INKY) {
-				// Inky: bottom-right corner
-				targetTile = {static_cast<int>(map.getWidth()) - 1, static_cast<int>(map.getHeight()) - 1};
-			} else {
-				// Clyde: bottom-left corner
-				targetTile = {0, static_cast<int>(map.getHeight()) - 1};
-			}
+			targetTile = Targeting::scatterTarget(map);
 		}
 	}
 
+	chooseMove(map, currentTile, targetTile, followPacmanField);
+}
+
+// The four targeting policies; Game's batched update calls each on its own range of ghosts
+template void Ghost::updateAI<Blinky>(MazeMap& map, const Pacman& pacman);
+template void Ghost::updateAI<Pinky>(MazeMap& map, const Pacman& pacman);
+template void Ghost::updateAI<Inky>(MazeMap& map, const Pacman& pacman);
+template void Ghost::updateAI<Clyde>(MazeMap& map, const Pacman& pacman);
+
+sf::Vector2i Ghost::tileAhead(const MazeMap& map, sf::Vector2i tile, MovementDir dir, int tiles) {
+	const int width = static_cast<int>(map.getWidth());
+	const int height = static_cast<int>(map.getHeight());
+
+	switch (dir) {
+		case MovementDir::UP: tile.y -= tiles; break;
+		case MovementDir::DOWN: tile.y += tiles; break;
+		case MovementDir::LEFT: tile.x -= tiles; break;
+		case MovementDir::RIGHT: tile.x += tiles; break;
+		case MovementDir::STATIC: break;
+	}
+
+	// Wraps at the maze edges
+	tile.x = ((tile.x % width) + width) % width;
+	tile.y = ((tile.y % height) + height) % height;
+	return tile;
+}
+
+void Ghost::chooseMove(MazeMap& map, sf::Vector2i currentTile, sf::Vector2i targetTile, bool followPacmanField) {
 	int dx = targetTile.x - currentTile.x;
 	int dy = targetTile.y - currentTile.y;
 
@@ -162,13 +138,30 @@ static MovementDir oppositeDirection(MovementDir d) {
 		tryOrder[2] = oppositeDirection(secondary);
 		tryOrder[3] = oppositeDirection(primary);
 	}
+
+	// Direct chasers walk down the shared distance field instead of steering greedily;
+	// the stable sort keeps the greedy order between equally short moves
+	if (followPacmanField && !onExitOrBelow) {
+		auto fieldDistance = [&](MovementDir dir) {
+			switch (dir) {
+				case MovementDir::UP: return map.getPacmanDistance({currentTile.x, currentTile.y - 1});
+				case MovementDir::DOWN: return map.getPacmanDistance({currentTile.x, currentTile.y + 1});
+				case MovementDir::LEFT: return map.getPacmanDistance({currentTile.x - 1, currentTile.y});
+				case MovementDir::RIGHT: return map.getPacmanDistance({currentTile.x + 1, currentTile.y});
+				default: return MazeMap::UNREACHABLE;
+			}
+		};
+		std::stable_sort(std::begin(tryOrder), std::end(tryOrder), [&](MovementDir a, MovementDir b) {
+			return fieldDistance(a) < fieldDistance(b);
+		});
+	}
 	MovementDir oppositeOfLast = oppositeDirection(lastDirection);
 
 	for (auto dir : tryOrder) {
 		if (dir == MovementDir::STATIC) continue;
 
-		// Prevent moving down from the box exit tile (don't allow re-entry)
-		if (currentTile == boxExitTile && dir == MovementDir::DOWN) {
+		// Prevent moving down through the house door (don't allow re-entry)
+		if (isHouseDoorTile(currentTile) && dir == MovementDir::DOWN) {
 			continue;
 		}
 
@@ -178,42 +171,46 @@ static MovementDir oppositeDirection(MovementDir d) {
 		}
 
 		if (map.entityCanMove(*this, dir)) {
-			sf::Vector2i nextTile = currentTile;
-			switch (dir) {
-				case MovementDir::UP: nextTile.y -= 1; break;
-				case MovementDir::DOWN: nextTile.y += 1; break;
-				case MovementDir::LEFT:
-					nextTile.x -= 1;
-					if (nextTile.x < 0) nextTile.x = static_cast<int>(map.getWidth()) - 1;
-					break;
-				case MovementDir::RIGHT:
-					nextTile.x += 1;
-					if (nextTile.x >= static_cast<int>(map.getWidth())) nextTile.x = 0;
-					break;
-				case MovementDir::STATIC: break;
-			}
+			moveToNeighbour(map, currentTile, dir);
+			return;
+		}
+	}
+}
 
-			// Set appropriate sprite and start the move toward the tile center
-			if (isVulnerable) {
-				// Use vulnerable sprite regardless of direction
-				setActiveSprite("vulnerable", 0);
-			} else {
-				switch (dir) {
-					case MovementDir::UP: setActiveSprite("up_walking", 0); break;
-					case MovementDir::DOWN: setActiveSprite("down_walking", 0); break;
-					case MovementDir::LEFT: setActiveSprite("left_walking", 0); break;
-					case MovementDir::RIGHT: setActiveSprite("right_walking", 0); break;
-					default: break;
-				}
-			}
+void Ghost::moveToNeighbour(MazeMap& map, sf::Vector2i currentTile, MovementDir dir) {
+	sf::Vector2i nextTile = currentTile;
+	switch (dir) {
+		case MovementDir::UP: nextTile.y -= 1; break;
+		case MovementDir::DOWN: nextTile.y += 1; break;
+		case MovementDir::LEFT:
+			nextTile.x -= 1;
+			if (nextTile.x < 0) nextTile.x = static_cast<int>(map.getWidth()) - 1;
+			break;
+		case MovementDir::RIGHT:
+			nextTile.x += 1;
+			if (nextTile.x >= static_cast<int>(map.getWidth())) nextTile.x = 0;
+			break;
+		case MovementDir::STATIC: break;
+	}
 
-			lastDirection = dir;
-			allowReversal = false;  // Reset reversal flag after making a move
-			sf::Vector2f center = map.getTargetTileCenter(nextTile);
-			startMove(dir, center);
-			return;
+	// Set appropriate sprite and start the move toward the tile center
+	if (isVulnerable) {
+		// Use vulnerable sprite regardless of direction
+		setActiveSprite("vulnerable", 0);
+	} else {
+		switch (dir) {
+			case MovementDir::UP: setActiveSprite("up_walking", 0); break;
+			case MovementDir::DOWN: setActiveSprite("down_walking", 0); break;
+			case MovementDir::LEFT: setActiveSprite("left_walking", 0); break;
+			case MovementDir::RIGHT: setActiveSprite("right_walking", 0); break;
+			default: break;
 		}
 	}
+
+	lastDirection = dir;
+	allowReversal = false;  // Reset reversal flag after making a move
+	sf::Vector2f center = map.getTargetTileCenter(nextTile);
+	startMove(dir, center);
 }
 
 void Ghost::setVulnerable(bool vulnerable) {
@@ -235,3 +232,11 @@ void Ghost::endVulnerable() {
 	setVulnerable(false);
 }
 
+void Ghost::returnHome() {
+	endVulnerable();
+	teleport(homePosition);
+	hasExitedBox = aiType == AIType::BLINKY;
+	lastDirection = MovementDir::STATIC;
+	allowReversal = true;
+}
+
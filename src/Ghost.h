@@ -42,10 +42,40 @@ public:
 	// Set the box boundary (ghosts can't re-enter beyond this Y coordinate)
 	void setBoxBoundaryY(int boundaryY) { boxBoundaryY = boundaryY; }
 
-	// AI step for ghosts with type-specific targeting logic
+	// A ghost placed outside the box skips heading for the exit first
+	void setHasExitedBox(bool exited) { hasExitedBox = exited; }
+	bool getHasExitedBox() const { return hasExitedBox; }
+
+	// Where returnHome() puts the ghost, e.g. its start tile in the house
+	void setHomePosition(sf::Vector2f position) { homePosition = position; }
+
+	// Sends the ghost back to its home position, no longer vulnerable, to leave the box again
+	void returnHome();
+
+	// Versus mode: a player steers this ghost with setRequestedDirection() instead of its AI
+	void setPlayerControlled(bool controlled) { playerControlled = controlled; }
+	void setRequestedDirection(MovementDir dir) { requestedDirection = dir; }
+
+	// AI step with the chase and scatter targets of Targeting (Blinky, Pinky, Inky
+	// or Clyde), chosen at compile time; instantiated for those four in Ghost.cpp
+	template <typename Targeting>
 	void updateAI(MazeMap& map, const Pacman& pacman);
 
+	// The tile the given number of tiles from tile in dir, wrapping at the maze edges
+	static sf::Vector2i tileAhead(const MazeMap& map, sf::Vector2i tile, MovementDir dir, int tiles);
+
 private:
+	// Picks the best legal move toward targetTile, or down Pac-Man's distance field
+	void chooseMove(MazeMap& map, sf::Vector2i currentTile, sf::Vector2i targetTile, bool followPacmanField);
+
+	// The door is two tiles wide: the exit tile and the one to its left
+	bool isHouseDoorTile(sf::Vector2i tile) const {
+		return tile.y == boxExitTile.y && (tile.x == boxExitTile.x || tile.x == boxExitTile.x - 1);
+	}
+
+	// Starts the one-tile move in dir, with the matching sprite
+	void moveToNeighbour(MazeMap& map, sf::Vector2i currentTile, MovementDir dir);
+
 	Mode currentMode;
 	MovementDir lastDirection;
 	bool allowReversal;
@@ -55,6 +85,9 @@ private:
 	int boxBoundaryY;
 	bool isVulnerable;
 	Mode previousMode;  // Mode to return to after vulnerable ends
+	sf::Vector2f homePosition;
+	bool playerControlled = false;
+	MovementDir requestedDirection = MovementDir::STATIC;
 };
 
 #endif
@@ -0,0 +1,93 @@
+#include "HudNumber.h"
+#include <algorithm>
+
+void HudNumber::setAtlas(const DigitAtlas& digitAtlas, unsigned int maxDigits) {
+    atlas = &digitAtlas;
+    slotCount = std::min(maxDigits, MAX_DIGITS);
+
+    vertices.setPrimitiveType(sf::PrimitiveType::Triangles);
+    vertices.resize(slotCount * 6);
+
+    sf::Vector2f cell = atlas->getCellSize();
+    for (unsigned int slot = 0; slot < slotCount; ++slot) {
+        sf::Vertex* quad = &vertices[slot * 6];
+        float left = slot * cell.x;
+
+        quad[0].position = {left, 0.0f};
+        quad[1].position = {left + cell.x, 0.0f};
+        quad[2].position = {left, cell.y};
+        quad[3].position = {left, cell.y};
+        quad[4].position = {left + cell.x, 0.0f};
+        quad[5].position = {left + cell.x, cell.y};
+
+        shownDigits[slot] = -2;  // force setSlot to write every quad once
+    }
+
+    writeDigits();
+}
+
+void HudNumber::setValue(unsigned int newValue) {
+    if (newValue == value) return;
+
+    value = newValue;
+    if (atlas) writeDigits();
+}
+
+void HudNumber::writeDigits() {
+    unsigned int remaining = value;
+    std::array<int, MAX_DIGITS> digits{};
+    unsigned int digitCount = 0;
+    do {
+        digits[digitCount++] = remaining % 10;
+        remaining /= 10;
+    } while (remaining > 0 && digitCount < MAX_DIGITS);
+
+    // digits holds the number least significant first
+    for (unsigned int slot = 0; slot < slotCount; ++slot) {
+        setSlot(slot, slot < digitCount ? digits[digitCount - 1 - slot] : -1);
+    }
+}
+
+void HudNumber::setSlot(unsigned int slot, int digit) {
+    if (shownDigits[slot] == digit) return;
+    shownDigits[slot] = digit;
+
+    sf::Vertex* quad = &vertices[slot * 6];
+    sf::Color color = digit >= 0 ? sf::Color::White : sf::Color::Transparent;
+    sf::FloatRect rect = atlas->getDigitRect(std::max(digit, 0));
+    float left = rect.position.x;
+    float right = rect.position.x + rect.size.x;
+    float top = rect.position.y;
+    float bottom = rect.position.y + rect.size.y;
+
+    quad[0].texCoords = {left, top};
+    quad[1].texCoords = {right, top};
+    quad[2].texCoords = {left, bottom};
+    quad[3].texCoords = {left, bottom};
+    quad[4].texCoords = {right, top};
+    quad[5].texCoords = {right, bottom};
+
+    for (int i = 0; i < 6; ++i) {
+        quad[i].color = color;
+    }
+}
+
+void HudNumber::drawSoftware(SoftwareRenderer& renderer) const {
+    if (!atlas) return;
+
+    sf::Vector2f cell = atlas->getCellSize();
+    for (unsigned int slot = 0; slot < slotCount; ++slot) {
+        if (shownDigits[slot] < 0) continue;
+
+        renderer.blit(atlas->getImage(), sf::IntRect(atlas->getDigitRect(shownDigits[slot])),
+                      getTransform().transformPoint({slot * cell.x, 0.0f}));
+    }
+}
+
+void HudNumber::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    if (!atlas) return;
+
+    states.transform *= getTransform();
+    states.texture = &atlas->getTexture();
+    target.draw(vertices, states);
+}
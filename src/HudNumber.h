@@ -0,0 +1,47 @@
+#ifndef HUDNUMBER_H
+#define HUDNUMBER_H
+
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Transformable.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <array>
+
+#include "DigitAtlas.h"
+#include "SoftwareRenderer.h"
+
+// Left-aligned counter drawn from a DigitAtlas. setValue() rewrites only the
+// quads of digits that changed and never allocates.
+class HudNumber : public sf::Drawable, public sf::Transformable {
+public:
+    static constexpr unsigned int MAX_DIGITS = 10;
+
+    // Builds maxDigits quads (capped at MAX_DIGITS); the atlas must outlive this widget
+    void setAtlas(const DigitAtlas& digitAtlas, unsigned int maxDigits);
+
+    void setValue(unsigned int newValue);
+
+    unsigned int getValue() const { return value; }
+
+    // What draw() puts on screen, from the atlas image; only position and
+    // origin are applied, as scaled digits cannot be blitted
+    void drawSoftware(SoftwareRenderer& renderer) const;
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    void writeDigits();
+
+    // digit < 0 hides the slot
+    void setSlot(unsigned int slot, int digit);
+
+    const DigitAtlas* atlas = nullptr;
+    sf::VertexArray vertices;
+    unsigned int slotCount = 0;
+
+    std::array<int, MAX_DIGITS> shownDigits{};
+    unsigned int value = 0;
+};
+
+#endif
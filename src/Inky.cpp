@@ -1,5 +0,0 @@
-#include "Inky.h"
-
-void Inky::setTargetTile(Entity& pacman, Entity& blinky) {
-
-};
@@ -2,10 +2,21 @@
 #define INKY_H
 
 #include "Ghost.h"
+#include "MazeMap.h"
+#include <SFML/System/Vector2.hpp>
 
-class Inky : public Ghost {
-public:
-    void setTargetTile(Entity& pacman, Entity& blinky);
+// Blue: targets 2 tiles ahead of Pac-Man and scatters to the bottom-right corner
+struct Inky {
+    static constexpr Ghost::AIType type = Ghost::AIType::INKY;
+    static constexpr bool followsPacmanField = false;
+
+    static sf::Vector2i chaseTarget(const MazeMap& map, sf::Vector2i pacmanTile, MovementDir pacmanDir) {
+        return Ghost::tileAhead(map, pacmanTile, pacmanDir, 2);
+    }
+
+    static sf::Vector2i scatterTarget(const MazeMap& map) {
+        return {static_cast<int>(map.getWidth()) - 1, static_cast<int>(map.getHeight()) - 1};
+    }
 };
 
 #endif
@@ -0,0 +1,48 @@
+#include "InputQueue.h"
+#include <SFML/Window/Keyboard.hpp>
+#include <optional>
+
+static std::optional<MovementDir> directionForKey(sf::Keyboard::Key key, InputQueue::KeySet keys) {
+    bool arrows = keys != InputQueue::KeySet::WASD;
+    bool wasd = keys != InputQueue::KeySet::ARROWS;
+
+    switch (key) {
+        case sf::Keyboard::Key::W: return wasd ? std::optional(MovementDir::UP) : std::nullopt;
+        case sf::Keyboard::Key::A: return wasd ? std::optional(MovementDir::LEFT) : std::nullopt;
+        case sf::Keyboard::Key::S: return wasd ? std::optional(MovementDir::DOWN) : std::nullopt;
+        case sf::Keyboard::Key::D: return wasd ? std::optional(MovementDir::RIGHT) : std::nullopt;
+        case sf::Keyboard::Key::Q: return wasd ? std::optional(MovementDir::STATIC) : std::nullopt;
+        case sf::Keyboard::Key::Up: return arrows ? std::optional(MovementDir::UP) : std::nullopt;
+        case sf::Keyboard::Key::Left: return arrows ? std::optional(MovementDir::LEFT) : std::nullopt;
+        case sf::Keyboard::Key::Down: return arrows ? std::optional(MovementDir::DOWN) : std::nullopt;
+        case sf::Keyboard::Key::Right: return arrows ? std::optional(MovementDir::RIGHT) : std::nullopt;
+        default:
+            return std::nullopt;
+    }
+}
+
+bool InputQueue::pushEvent(const sf::Event& event, sf::Time timestamp) {
+    std::optional<MovementDir> direction;
+    bool pressed = false;
+
+    if (const auto* keyPressed = event.getIf<sf::Event::KeyPressed>()) {
+        direction = directionForKey(keyPressed->code, keys);
+        pressed = true;
+    } else if (const auto* keyReleased = event.getIf<sf::Event::KeyReleased>()) {
+        direction = directionForKey(keyReleased->code, keys);
+    }
+
+    if (!direction.has_value()) return false;
+
+    pending.push_back({*direction, pressed, timestamp});
+    return true;
+}
+
+void InputQueue::popUntil(sf::Time deadline, std::vector<InputEvent>& out) {
+    out.clear();
+
+    while (!pending.empty() && pending.front().timestamp <= deadline) {
+        out.push_back(pending.front());
+        pending.pop_front();
+    }
+}
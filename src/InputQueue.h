@@ -0,0 +1,47 @@
+#ifndef INPUTQUEUE_H
+#define INPUTQUEUE_H
+
+#include <SFML/System/Time.hpp>
+#include <SFML/Window/Event.hpp>
+#include <deque>
+#include <vector>
+
+#include "Entity.h"
+
+struct InputEvent {
+    MovementDir direction;
+    bool pressed;
+    sf::Time timestamp;
+};
+
+// Buffers direction key presses/releases from window events until the
+// simulation tick covering their timestamp consumes them
+class InputQueue {
+public:
+    // Which keys this queue listens to; versus mode splits them between two players
+    enum class KeySet {
+        ARROWS_AND_WASD,
+        ARROWS,
+        WASD
+    };
+
+    explicit InputQueue(KeySet keySet = KeySet::ARROWS_AND_WASD) : keys(keySet) {}
+
+    // Queues the event if it is a movement key; returns false otherwise
+    bool pushEvent(const sf::Event& event, sf::Time timestamp);
+
+    void push(const InputEvent& input) { pending.push_back(input); }
+
+    // Moves every input with timestamp <= deadline into out (cleared first)
+    void popUntil(sf::Time deadline, std::vector<InputEvent>& out);
+
+    bool isEmpty() const { return pending.empty(); }
+
+    void clear() { pending.clear(); }
+
+private:
+    KeySet keys;
+    std::deque<InputEvent> pending;
+};
+
+#endif
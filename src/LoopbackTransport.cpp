@@ -0,0 +1,31 @@
+#include "LoopbackTransport.h"
+#include <algorithm>
+
+LoopbackTransport::LoopbackTransport(sf::Time latencyParam, sf::Time jitterParam, std::uint64_t seed)
+    : latency(latencyParam), jitter(jitterParam), random(seed) {}
+
+void LoopbackTransport::send(const InputPacket& packet) {
+    std::int64_t jitterMicroseconds = jitter.asMicroseconds();
+    std::uniform_int_distribution<std::int64_t> offset(-jitterMicroseconds, jitterMicroseconds);
+
+    sf::Time delay = std::max(sf::Time::Zero, latency + sf::microseconds(offset(random)));
+    inFlight.push_back({clock.getElapsedTime() + delay, packet});
+}
+
+void LoopbackTransport::receive(std::vector<InputPacket>& out) {
+    out.clear();
+    sf::Time now = clock.getElapsedTime();
+
+    // Delivered in arrival order, which jitter may make differ from send order
+    std::stable_sort(inFlight.begin(), inFlight.end(), [](const InFlight& a, const InFlight& b) {
+        return a.deliverAt < b.deliverAt;
+    });
+
+    auto arrived = std::find_if(inFlight.begin(), inFlight.end(), [now](const InFlight& item) {
+        return item.deliverAt > now;
+    });
+    for (auto it = inFlight.begin(); it != arrived; ++it) {
+        out.push_back(it->packet);
+    }
+    inFlight.erase(inFlight.begin(), arrived);
+}
@@ -0,0 +1,37 @@
+#ifndef LOOPBACKTRANSPORT_H
+#define LOOPBACKTRANSPORT_H
+
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Time.hpp>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "NetTransport.h"
+
+// In-process stand-in for a network link: every sent packet comes back from
+// receive() after latency, plus or minus up to jitter, so packets can overtake
+// each other. The same seed gives the same delays.
+class LoopbackTransport : public NetTransport {
+public:
+    LoopbackTransport(sf::Time latency, sf::Time jitter, std::uint64_t seed = 1);
+
+    void send(const InputPacket& packet) override;
+
+    void receive(std::vector<InputPacket>& out) override;
+
+private:
+    struct InFlight {
+        sf::Time deliverAt;
+        InputPacket packet;
+    };
+
+    sf::Time latency;
+    sf::Time jitter;
+    std::mt19937_64 random;
+
+    sf::Clock clock;
+    std::vector<InFlight> inFlight;
+};
+
+#endif
@@ -0,0 +1,435 @@
+#include "MazeGenerator.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace {
+
+// SplitMix64 rather than <random>: distributions and std::shuffle differ between
+// standard libraries, and a seed must give the same maze everywhere
+class SeededRandom {
+public:
+    explicit SeededRandom(std::uint64_t seed) : state(seed) {}
+
+    std::uint64_t next() {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    std::size_t below(std::size_t bound) { return static_cast<std::size_t>(next() % bound); }
+
+    bool chance(float probability) { return static_cast<float>(next() >> 40) / static_cast<float>(1ull << 24) < probability; }
+
+    template <typename T>
+    void shuffle(std::vector<T>& values) {
+        for (std::size_t i = values.size(); i > 1; --i) {
+            std::swap(values[i - 1], values[below(i)]);
+        }
+    }
+
+private:
+    std::uint64_t state;
+};
+
+struct DisjointSet {
+    explicit DisjointSet(std::size_t count) : parent(count) {
+        for (std::size_t i = 0; i < count; ++i) parent[i] = i;
+    }
+
+    std::size_t find(std::size_t i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    }
+
+    bool unite(std::size_t a, std::size_t b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        parent[b] = a;
+        return true;
+    }
+
+    std::vector<std::size_t> parent;
+};
+
+enum class EdgeKind {
+    RIGHT,   // to the next junction column
+    DOWN,    // to the next junction row
+    CROSS,   // from the centre column across to its mirror
+    TUNNEL   // from column 0 out through the side wall
+};
+
+struct Edge {
+    EdgeKind kind;
+    int column;
+    int row;
+};
+
+} // namespace
+
+MazeGenerator::MazeGenerator(const Settings& settings) : settings(settings) {
+    const sf::Vector2u size = settings.size;
+    if (size.x % 2 != 0 || size.x < 20 || size.y < 17) {
+        throw std::runtime_error("Generated mazes must be at least 20x17 tiles with an even width");
+    }
+
+    // The centre column stays at least 2 tiles from the middle so crossings are 1 tile wide
+    const int halfWidth = static_cast<int>(size.x / 2);
+    junctionColumns = (halfWidth - 3) / 3 + 1;
+    junctionRows = (static_cast<int>(size.y) - 3) / 3 + 1;
+
+    // The house interior needs 6 tiles between the ring's side roads
+    const int centreGap = static_cast<int>(size.x) - 2 - 2 * junctionTile(junctionColumns - 1, 0).x;
+    houseColumn = centreGap >= 6 ? junctionColumns - 1 : junctionColumns - 2;
+    houseRow = (junctionRows - 3) / 2;
+}
+
+bool MazeGenerator::isHouseJunction(int column, int row) const {
+    return column > houseColumn && row == houseRow + 1;
+}
+
+GeneratedMaze MazeGenerator::generate(std::uint64_t seed) const {
+    SeededRandom random(seed);
+    const int width = static_cast<int>(settings.size.x);
+    const int height = static_cast<int>(settings.size.y);
+    const int centreColumn = junctionColumns - 1;
+
+    std::vector<bool> openRight(junctionColumns * junctionRows, false);
+    std::vector<bool> openDown(junctionColumns * junctionRows, false);
+    std::vector<bool> openCross(junctionRows, false);
+    std::vector<bool> openTunnel(junctionRows, false);
+
+    auto isOpen = [&](const Edge& edge) {
+        switch (edge.kind) {
+            case EdgeKind::RIGHT: return static_cast<bool>(openRight[junctionIndex(edge.column, edge.row)]);
+            case EdgeKind::DOWN: return static_cast<bool>(openDown[junctionIndex(edge.column, edge.row)]);
+            case EdgeKind::CROSS: return static_cast<bool>(openCross[edge.row]);
+            case EdgeKind::TUNNEL: return static_cast<bool>(openTunnel[edge.row]);
+        }
+        return false;
+    };
+    auto open = [&](const Edge& edge) {
+        switch (edge.kind) {
+            case EdgeKind::RIGHT: openRight[junctionIndex(edge.column, edge.row)] = true; break;
+            case EdgeKind::DOWN: openDown[junctionIndex(edge.column, edge.row)] = true; break;
+            case EdgeKind::CROSS: openCross[edge.row] = true; break;
+            case EdgeKind::TUNNEL: openTunnel[edge.row] = true; break;
+        }
+    };
+    // Corridors may not run into or through the ghost house
+    auto isAllowed = [&](const Edge& edge) {
+        if (isHouseJunction(edge.column, edge.row)) return false;
+        if (edge.kind == EdgeKind::RIGHT) return !isHouseJunction(edge.column + 1, edge.row);
+        if (edge.kind == EdgeKind::DOWN) return !isHouseJunction(edge.column, edge.row + 1);
+        if (edge.kind == EdgeKind::CROSS) return edge.row != houseRow + 1;
+        return true;
+    };
+
+    // The ring road around the house is always there
+    DisjointSet junctions(junctionColumns * junctionRows);
+    for (int column = houseColumn; column < centreColumn; ++column) {
+        for (int row : {houseRow, houseRow + 2}) {
+            open({EdgeKind::RIGHT, column, row});
+            junctions.unite(junctionIndex(column, row), junctionIndex(column + 1, row));
+        }
+    }
+    for (int row = houseRow; row < houseRow + 2; ++row) {
+        open({EdgeKind::DOWN, houseColumn, row});
+        junctions.unite(junctionIndex(houseColumn, row), junctionIndex(houseColumn, row + 1));
+    }
+    openCross[houseRow] = true;
+    openCross[houseRow + 2] = true;
+
+    // Random spanning tree over the left half (the mirror and a crossing connect
+    // the right half), with a share of the leftover corridors opened as loops
+    std::vector<Edge> candidates;
+    for (int row = 0; row < junctionRows; ++row) {
+        for (int column = 0; column < junctionColumns; ++column) {
+            if (column + 1 < junctionColumns) candidates.push_back({EdgeKind::RIGHT, column, row});
+            if (row + 1 < junctionRows) candidates.push_back({EdgeKind::DOWN, column, row});
+        }
+    }
+    random.shuffle(candidates);
+
+    for (const Edge& edge : candidates) {
+        if (!isAllowed(edge) || isOpen(edge)) continue;
+
+        int neighbour = edge.kind == EdgeKind::RIGHT ? junctionIndex(edge.column + 1, edge.row)
+                                                     : junctionIndex(edge.column, edge.row + 1);
+        if (junctions.unite(junctionIndex(edge.column, edge.row), neighbour) || random.chance(settings.extraCorridorChance)) {
+            open(edge);
+        }
+    }
+
+    for (int row = 0; row < junctionRows; ++row) {
+        Edge cross{EdgeKind::CROSS, centreColumn, row};
+        if (isAllowed(cross) && random.chance(settings.extraCorridorChance)) {
+            open(cross);
+        }
+    }
+
+    std::vector<int> tunnelRows;
+    for (int row = 1; row + 1 < junctionRows; ++row) {
+        tunnelRows.push_back(row);
+    }
+    random.shuffle(tunnelRows);
+    for (std::size_t i = 0; i < std::min<std::size_t>(settings.tunnelCount, tunnelRows.size()); ++i) {
+        openTunnel[tunnelRows[i]] = true;
+    }
+
+    // No dead ends: give every junction with a single corridor a second one
+    for (int row = 0; row < junctionRows; ++row) {
+        for (int column = 0; column < junctionColumns; ++column) {
+            if (isHouseJunction(column, row)) continue;
+
+            std::vector<Edge> incident;
+            if (column + 1 < junctionColumns) incident.push_back({EdgeKind::RIGHT, column, row});
+            if (column > 0) incident.push_back({EdgeKind::RIGHT, column - 1, row});
+            if (row + 1 < junctionRows) incident.push_back({EdgeKind::DOWN, column, row});
+            if (row > 0) incident.push_back({EdgeKind::DOWN, column, row - 1});
+            if (column == centreColumn) incident.push_back({EdgeKind::CROSS, column, row});
+            if (column == 0 && row > 0 && row + 1 < junctionRows) incident.push_back({EdgeKind::TUNNEL, column, row});
+
+            std::vector<Edge> closed;
+            int degree = 0;
+            for (const Edge& edge : incident) {
+                if (isOpen(edge)) {
+                    degree++;
+                } else if (isAllowed(edge)) {
+                    closed.push_back(edge);
+                }
+            }
+
+            if (degree < 2 && !closed.empty()) {
+                open(closed[random.below(closed.size())]);
+            }
+        }
+    }
+
+    GeneratedMaze maze;
+    maze.seed = seed;
+    maze.size = settings.size;
+    maze.collisionData.assign(width * height, 1);
+    maze.pelletData.assign(width * height, 0);
+
+    auto carve = [&](int x, int y) {
+        maze.collisionData[x + y * width] = 0;
+        maze.collisionData[(width - 1 - x) + y * width] = 0;
+    };
+
+    for (int row = 0; row < junctionRows; ++row) {
+        for (int column = 0; column < junctionColumns; ++column) {
+            if (isHouseJunction(column, row)) continue;
+
+            sf::Vector2i tile = junctionTile(column, row);
+            carve(tile.x, tile.y);
+
+            if (isOpen({EdgeKind::RIGHT, column, row})) {
+                carve(tile.x + 1, tile.y);
+                carve(tile.x + 2, tile.y);
+            }
+            if (isOpen({EdgeKind::DOWN, column, row})) {
+                carve(tile.x, tile.y + 1);
+                carve(tile.x, tile.y + 2);
+            }
+            if (column == centreColumn && openCross[row]) {
+                for (int x = tile.x + 1; x < width / 2; ++x) carve(x, tile.y);
+            }
+            if (column == 0 && openTunnel[row]) {
+                carve(0, tile.y);
+            }
+        }
+    }
+
+    // Ghost house: walls one tile inside the ring road, a 2-tile door at the top centre
+    const sf::Vector2i ringTopLeft = junctionTile(houseColumn, houseRow);
+    const sf::Vector2i houseTopLeft(ringTopLeft.x + 1, ringTopLeft.y + 1);
+    const sf::Vector2i houseBottomRight(width - 2 - ringTopLeft.x, ringTopLeft.y + 5);
+
+    for (int y = houseTopLeft.y + 1; y < houseBottomRight.y; ++y) {
+        for (int x = houseTopLeft.x + 1; x < width / 2; ++x) carve(x, y);
+    }
+    carve(width / 2 - 1, houseTopLeft.y);
+    maze.houseDoorTile = {width / 2, houseTopLeft.y};
+    maze.houseInterior = sf::IntRect({houseTopLeft.x + 1, houseTopLeft.y + 1},
+                                     {houseBottomRight.x - houseTopLeft.x - 1, houseBottomRight.y - houseTopLeft.y - 1});
+
+    // Where the classic maze starts them: Blinky on the ring road above the door,
+    // the others across the middle row of the house, Pac-Man on the next row of
+    // junctions down. The interior is at least 4 tiles wide.
+    const int houseMiddleRow = houseTopLeft.y + 2;
+    maze.ghostStartTiles = {sf::Vector2i(width / 2, ringTopLeft.y), sf::Vector2i(width / 2, houseMiddleRow),
+                            sf::Vector2i(width / 2 - 2, houseMiddleRow), sf::Vector2i(width / 2 + 1, houseMiddleRow)};
+    maze.pacmanStartTile = junctionTile(centreColumn, houseRow + 3);
+
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            bool inHouse = x >= houseTopLeft.x && x <= houseBottomRight.x && y >= houseTopLeft.y && y <= houseBottomRight.y;
+            bool inTunnel = x == 0 || x == width - 1;
+            if (maze.collisionData[x + y * width] == 0 && !inHouse && !inTunnel) {
+                maze.pelletData[x + y * width] = 1;
+            }
+        }
+    }
+
+    for (int row : {1, junctionRows - 2}) {
+        sf::Vector2i tile = junctionTile(0, row);
+        maze.pelletData[tile.x + tile.y * width] = 2;
+        maze.pelletData[(width - 1 - tile.x) + tile.y * width] = 2;
+    }
+
+    if (!verify(maze)) {
+        throw std::runtime_error("Generated maze failed verification, seed " + std::to_string(seed));
+    }
+
+    return maze;
+}
+
+void MazeGenerator::generateBatch(std::uint64_t firstSeed, std::size_t count, unsigned int threadCount,
+                                  const std::function<void(const GeneratedMaze&)>& consume) const {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Seeds are handed out in order, so a maze only depends on its seed, not on the thread count
+    std::atomic<std::size_t> nextMaze{0};
+    std::exception_ptr firstError;
+    std::mutex errorMutex;
+
+    auto worker = [&]() {
+        try {
+            for (std::size_t i = nextMaze++; i < count; i = nextMaze++) {
+                consume(generate(firstSeed + i));
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!firstError) firstError = std::current_exception();
+            nextMaze = count;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        workers.emplace_back(worker);
+    }
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+}
+
+bool MazeGenerator::verify(const GeneratedMaze& maze) {
+    const int width = static_cast<int>(maze.size.x);
+    const int height = static_cast<int>(maze.size.y);
+    const std::size_t tileCount = static_cast<std::size_t>(width) * height;
+    if (tileCount == 0 || maze.collisionData.size() != tileCount || maze.pelletData.size() != tileCount) {
+        return false;
+    }
+
+    auto isPath = [&](int x, int y) {
+        // Tunnels wrap horizontally
+        x = (x + width) % width;
+        return y >= 0 && y < height && maze.collisionData[x + y * width] == 0;
+    };
+
+    std::size_t openTiles = 0;
+    std::vector<int> toVisit;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int index = x + y * width;
+            int mirror = (width - 1 - x) + y * width;
+            if (maze.collisionData[index] != maze.collisionData[mirror] || maze.pelletData[index] != maze.pelletData[mirror]) {
+                return false;
+            }
+            if (!isPath(x, y)) continue;
+
+            int exits = isPath(x - 1, y) + isPath(x + 1, y) + isPath(x, y - 1) + isPath(x, y + 1);
+            if (exits < 2) return false;
+
+            openTiles++;
+            if (toVisit.empty()) toVisit.push_back(index);
+        }
+    }
+
+    if (!isPath(maze.houseDoorTile.x, maze.houseDoorTile.y) || !isPath(maze.houseDoorTile.x, maze.houseDoorTile.y + 1)) {
+        return false;
+    }
+
+    const sf::IntRect& house = maze.houseInterior;
+    auto inHouse = [&](sf::Vector2i tile) {
+        return tile.x >= house.position.x && tile.x < house.position.x + house.size.x &&
+               tile.y >= house.position.y && tile.y < house.position.y + house.size.y;
+    };
+    if (house.size.x <= 0 || house.size.y <= 0 || !inHouse({maze.houseDoorTile.x, maze.houseDoorTile.y + 1})) {
+        return false;
+    }
+    for (int y = house.position.y; y < house.position.y + house.size.y; ++y) {
+        for (int x = house.position.x; x < house.position.x + house.size.x; ++x) {
+            if (!isPath(x, y)) return false;
+        }
+    }
+
+    for (std::size_t i = 0; i < maze.ghostStartTiles.size(); ++i) {
+        sf::Vector2i tile = maze.ghostStartTiles[i];
+        if (!isPath(tile.x, tile.y) || inHouse(tile) != (i > 0)) return false;
+    }
+    if (!isPath(maze.pacmanStartTile.x, maze.pacmanStartTile.y) || inHouse(maze.pacmanStartTile)) {
+        return false;
+    }
+
+    // Flood fill from the first open tile must reach every other one
+    std::vector<bool> visited(tileCount, false);
+    std::size_t reached = 0;
+    if (!toVisit.empty()) visited[toVisit.front()] = true;
+
+    while (!toVisit.empty()) {
+        int index = toVisit.back();
+        toVisit.pop_back();
+        reached++;
+
+        int x = index % width;
+        int y = index / width;
+        const sf::Vector2i neighbours[] = {{x - 1, y}, {x + 1, y}, {x, y - 1}, {x, y + 1}};
+        for (sf::Vector2i neighbour : neighbours) {
+            if (!isPath(neighbour.x, neighbour.y)) continue;
+
+            int neighbourIndex = (neighbour.x + width) % width + neighbour.y * width;
+            if (!visited[neighbourIndex]) {
+                visited[neighbourIndex] = true;
+                toVisit.push_back(neighbourIndex);
+            }
+        }
+    }
+
+    return openTiles > 0 && reached == openTiles;
+}
+
+bool MazeGenerator::saveToFiles(const GeneratedMaze& maze, const std::filesystem::path& mazePath, const std::filesystem::path& pelletPath) {
+    auto writeGrid = [&maze](const std::filesystem::path& path, const std::vector<int>& data) {
+        std::ofstream file(path);
+        if (!file.is_open()) return false;
+
+        for (unsigned int y = 0; y < maze.size.y; ++y) {
+            for (unsigned int x = 0; x < maze.size.x; ++x) {
+                file << data[x + y * maze.size.x] << (x + 1 < maze.size.x ? ' ' : '\n');
+            }
+        }
+
+        return static_cast<bool>(file);
+    };
+
+    return writeGrid(mazePath, maze.collisionData) && writeGrid(pelletPath, maze.pelletData);
+}
@@ -0,0 +1,72 @@
+#ifndef MAZEGENERATOR_H
+#define MAZEGENERATOR_H
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+// A maze in the layout of assets/game/maze.txt and pellets.txt, ready for MazeMap::loadMaze
+struct GeneratedMaze {
+    std::uint64_t seed = 0;
+    sf::Vector2u size;
+    std::vector<int> collisionData;  // 1=wall, 0=path
+    std::vector<int> pelletData;     // 0=none, 1=pellet, 2=power pellet
+    sf::Vector2i houseDoorTile;      // right-hand door tile, like (14, 12) in the classic maze
+    sf::IntRect houseInterior;       // the open tiles inside the house, below the door
+    sf::Vector2i pacmanStartTile;    // the junction on the left of the centre line below the house
+    std::array<sf::Vector2i, 4> ghostStartTiles;  // in AIType order: Blinky above the door, the others inside
+};
+
+// Builds left/right mirrored Pac-Man mazes: 1-tile corridors between junctions
+// 3 tiles apart, a ghost house inside a ring road at the centre, wrap-around
+// tunnels and no dead ends. The same settings and seed always give the same maze.
+class MazeGenerator {
+public:
+    struct Settings {
+        sf::Vector2u size = {28, 31};   // width must be even
+        unsigned int tunnelCount = 1;
+        float extraCorridorChance = 0.3f;  // share of non-tree corridors opened to add loops
+    };
+
+    // Throws if the size is too small to fit a ghost house and ring road
+    explicit MazeGenerator(const Settings& settings);
+
+    // Throws if the result fails verify(), which would be a generator bug
+    GeneratedMaze generate(std::uint64_t seed) const;
+
+    // Generates the mazes for seeds firstSeed .. firstSeed + count - 1 on threadCount
+    // threads (0: one per hardware thread). consume is called on the worker threads.
+    void generateBatch(std::uint64_t firstSeed, std::size_t count, unsigned int threadCount,
+                       const std::function<void(const GeneratedMaze&)>& consume) const;
+
+    // Mirror symmetry, an open house door and interior, start tiles on open
+    // tiles (the ghosts' but Blinky's inside the house, Pac-Man's outside), a
+    // flood fill reaching every open tile (tunnels wrap) and at least two open
+    // neighbours for every open tile
+    static bool verify(const GeneratedMaze& maze);
+
+    static bool saveToFiles(const GeneratedMaze& maze, const std::filesystem::path& mazePath, const std::filesystem::path& pelletPath);
+
+private:
+    // Junctions on the left half; the right half is the mirror image
+    sf::Vector2i junctionTile(int column, int row) const { return {1 + 3 * column, 1 + 3 * row}; }
+    int junctionIndex(int column, int row) const { return column + row * junctionColumns; }
+    bool isHouseJunction(int column, int row) const;
+
+    Settings settings;
+
+    int junctionColumns;
+    int junctionRows;
+
+    // The house sits inside the ring of junctions from houseColumn to the centre
+    // and from houseRow to houseRow + 2
+    int houseColumn;
+    int houseRow;
+};
+
+#endif
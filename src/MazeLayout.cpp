@@ -0,0 +1,45 @@
+#include "MazeLayout.h"
+
+std::shared_ptr<const MazeLayout> MazeLayout::create(const std::vector<int>& collisionData,
+                                                     const std::vector<int>& pelletData,
+                                                     sf::Vector2u mazeSize) {
+    std::size_t tileCount = static_cast<std::size_t>(mazeSize.x) * mazeSize.y;
+    if (tileCount == 0 || collisionData.size() != tileCount || pelletData.size() != tileCount) {
+        return nullptr;
+    }
+
+    return std::shared_ptr<const MazeLayout>(new MazeLayout(collisionData, pelletData, mazeSize));
+}
+
+MazeLayout::MazeLayout(const std::vector<int>& collisionData, const std::vector<int>& pelletData, sf::Vector2u mazeSize)
+    : size(mazeSize),
+      collision(collisionData.begin(), collisionData.end()),
+      pellets(pelletData.begin(), pelletData.end()) {
+
+    for (std::uint8_t pellet : pellets) {
+        if (pellet > 0) pelletCount++;
+    }
+
+    const int w = static_cast<int>(size.x);
+    const int h = static_cast<int>(size.y);
+    neighbours.assign(collision.size() * 4, -1);
+
+    for (int index = 0; index < static_cast<int>(collision.size()); ++index) {
+        int x = index % w;
+        int y = index / w;
+
+        const int candidates[4] = {
+            y > 0 ? index - w : -1,
+            y < h - 1 ? index + w : -1,
+            x > 0 ? index - 1 : index + w - 1,  // tunnels wrap horizontally
+            x < w - 1 ? index + 1 : index - w + 1,
+        };
+
+        for (int heading = 0; heading < 4; ++heading) {
+            int neighbour = candidates[heading];
+            if (neighbour >= 0 && collision[neighbour] != 1) {
+                neighbours[static_cast<std::size_t>(index) * 4 + heading] = neighbour;
+            }
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef MAZELAYOUT_H
+#define MAZELAYOUT_H
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// The read-only part of a maze: walls, where the pellets start and which open
+// tiles neighbour each tile. Built once and shared by every MazeMap playing it,
+// which only keeps track of the pellets eaten since.
+class MazeLayout {
+public:
+    // nullptr unless both grids hold exactly mazeSize tiles
+    static std::shared_ptr<const MazeLayout> create(const std::vector<int>& collisionData,
+                                                    const std::vector<int>& pelletData,
+                                                    sf::Vector2u mazeSize);
+
+    unsigned int getWidth() const { return size.x; }
+    unsigned int getHeight() const { return size.y; }
+    std::size_t getTileCount() const { return collision.size(); }
+
+    bool isWall(int index) const { return collision[index] == 1; }
+
+    // 0=none, 1=pellet, 2=power pellet, before any are eaten
+    std::uint8_t getPellet(int index) const { return pellets[index]; }
+    unsigned int getPelletCount() const { return pelletCount; }
+
+    // Open tile one step from index in heading (0 up, 1 down, 2 left, 3 right),
+    // wrapping horizontally like the tunnels, or -1 for a wall or the top/bottom edge
+    int openNeighbour(int index, int heading) const { return neighbours[static_cast<std::size_t>(index) * 4 + heading]; }
+
+private:
+    MazeLayout(const std::vector<int>& collisionData, const std::vector<int>& pelletData, sf::Vector2u mazeSize);
+
+    sf::Vector2u size;
+    std::vector<std::uint8_t> collision;  // 1=wall, 0=path
+    std::vector<std::uint8_t> pellets;
+    std::vector<int> neighbours;          // four per tile
+    unsigned int pelletCount = 0;
+};
+
+#endif
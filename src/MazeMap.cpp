@@ -1,77 +1,198 @@
 #include "MazeMap.h"
 #include "Entity.h"
+#include "SoftwareRenderer.h"
 #include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <bitset>
 #include <cmath>
 
-bool MazeMap::loadMaze(const std::vector<int>& collisionData,
-                       const std::vector<int>& pelletData,
+bool MazeMap::loadMaze(std::shared_ptr<const MazeLayout> sharedLayout,
                        sf::Texture& sharedTexture,
                        unsigned int tileSizeParam,
-                       sf::Vector2u baseMazeTexturePos,
+                       std::optional<sf::Vector2u> baseMazeTexturePos,
                        sf::Vector2u pelletMazeTexturePos) {
+    if (!sharedLayout) return false;
 
+    this->layout = std::move(sharedLayout);
+    this->width = layout->getWidth();
+    this->height = layout->getHeight();
     this->tileSize = tileSizeParam;
     this->texture = &sharedTexture;
-    this->collisionMap = collisionData;
-    this->pelletMap = pelletData;
     this->baseMazeTexPos = baseMazeTexturePos;
     this->pelletMazeTexPos = pelletMazeTexturePos;
 
-    pelletEaten.resize(width * height, false);
+    eatenBits.assign((layout->getTileCount() + 63) / 64, 0);
+    remainingPellets = layout->getPelletCount();
+    dirtyTiles.clear();
+    tracksDirtyTiles = false;
+    chunkCache.clear();
 
-    baseMazeSprite.emplace(*texture);
-    baseMazeSprite->setTextureRect(sf::IntRect(
-        sf::Vector2i(baseMazeTexturePos),
-        sf::Vector2i(width * tileSize, height * tileSize)
-    ));
+    pacmanDistance.clear();
+    pacmanDistanceSource.reset();
+    pelletIndexBuilt = false;
 
-    pelletVertices.setPrimitiveType(sf::PrimitiveType::Triangles);
-    pelletVertices.resize(width * height * 6);
+    return true;
+}
+
+void MazeMap::markTileDirty(sf::Vector2i tilePos) {
+    unsigned int chunksX = (width + CHUNK_TILES - 1) / CHUNK_TILES;
+    auto cached = chunkCache.find((tilePos.y / CHUNK_TILES) * chunksX + tilePos.x / CHUNK_TILES);
+    if (cached != chunkCache.end()) {
+        cached->second.pelletsDirty = true;
+    }
+
+    // Nothing to repaint until someone keeps a drawn copy of the map
+    if (!tracksDirtyTiles) return;
 
-    for (unsigned int x = 0; x < width; ++x) {
-        for (unsigned int y = 0; y < height; ++y) {
-            int tileIndex = x + y * width;
-            int pelletValue = pelletMap[tileIndex];
+    dirtyTiles.push_back(tilePos);
+}
 
-            sf::Vertex* triangles = &pelletVertices[tileIndex * 6];
+void MazeMap::eatPellet(sf::Vector2i tilePos) {
+    if (!hasPellet(tilePos)) return;
 
-            triangles[0].position = sf::Vector2f(x * tileSize, y * tileSize);
-            triangles[1].position = sf::Vector2f((x + 1) * tileSize, y * tileSize);
-            triangles[2].position = sf::Vector2f(x * tileSize, (y + 1) * tileSize);
-            triangles[3].position = sf::Vector2f(x * tileSize, (y + 1) * tileSize);
-            triangles[4].position = sf::Vector2f((x + 1) * tileSize, y * tileSize);
-            triangles[5].position = sf::Vector2f((x + 1) * tileSize, (y + 1) * tileSize);
+    int tileIndex = convert2DCoords(tilePos);
+    eatenBits[tileIndex / 64] |= std::uint64_t(1) << (tileIndex % 64);
+    remainingPellets--;
+    markTileDirty(tilePos);
 
-            float texX = pelletMazeTexturePos.x + x * tileSize;
-            float texY = pelletMazeTexturePos.y + y * tileSize;
+    if (pelletIndexBuilt) removeFromPelletIndex(tileIndex);
+}
 
-            triangles[0].texCoords = sf::Vector2f(texX, texY);
-            triangles[1].texCoords = sf::Vector2f(texX + tileSize, texY);
-            triangles[2].texCoords = sf::Vector2f(texX, texY + tileSize);
-            triangles[3].texCoords = sf::Vector2f(texX, texY + tileSize);
-            triangles[4].texCoords = sf::Vector2f(texX + tileSize, texY);
-            triangles[5].texCoords = sf::Vector2f(texX + tileSize, texY + tileSize);
+void MazeMap::removeFromPelletIndex(int tileIndex) {
+    // Only the tiles this pellet was nearest to can change, and they form a
+    // connected region around it: clear that region...
+    searchQueue.clear();
+    searchQueue.push_back(tileIndex);
+    pelletDistance[tileIndex] = UNREACHABLE;
+    nearestPelletIndex[tileIndex] = -1;
+
+    for (std::size_t head = 0; head < searchQueue.size(); ++head) {
+        for (int heading = 0; heading < 4; ++heading) {
+            int neighbour = layout->openNeighbour(searchQueue[head], heading);
+            if (neighbour < 0 || nearestPelletIndex[neighbour] != tileIndex) continue;
+
+            pelletDistance[neighbour] = UNREACHABLE;
+            nearestPelletIndex[neighbour] = -1;
+            searchQueue.push_back(neighbour);
+        }
+    }
 
-            sf::Color color = (pelletValue > 0) ? sf::Color::White : sf::Color::Transparent;
-            for (int i = 0; i < 6; ++i) {
-                triangles[i].color = color;
+    // ...then seed it from the unchanged tiles on its border, nearest first
+    repairSeeds.clear();
+    for (int index : searchQueue) {
+        for (int heading = 0; heading < 4; ++heading) {
+            int neighbour = layout->openNeighbour(index, heading);
+            if (neighbour < 0 || nearestPelletIndex[neighbour] < 0) continue;
+
+            int distance = pelletDistance[neighbour] + 1;
+            if (distance < pelletDistance[index]) {
+                pelletDistance[index] = distance;
+                nearestPelletIndex[index] = nearestPelletIndex[neighbour];
             }
         }
+        if (nearestPelletIndex[index] >= 0) {
+            repairSeeds.push_back({pelletDistance[index], index});
+        }
     }
+    std::sort(repairSeeds.begin(), repairSeeds.end());
+
+    // and grow inwards breadth-first, merging the seeds in as their distance comes up
+    searchQueue.clear();
+    std::size_t nextSeed = 0;
+    std::size_t head = 0;
+    while (head < searchQueue.size() || nextSeed < repairSeeds.size()) {
+        int index;
+        if (nextSeed < repairSeeds.size() &&
+            (head == searchQueue.size() || repairSeeds[nextSeed].first <= pelletDistance[searchQueue[head]])) {
+            auto [distance, seedIndex] = repairSeeds[nextSeed++];
+            if (pelletDistance[seedIndex] < distance) continue;
+            index = seedIndex;
+        } else {
+            index = searchQueue[head++];
+        }
 
-    return true;
+        int nextDistance = pelletDistance[index] + 1;
+        for (int heading = 0; heading < 4; ++heading) {
+            int neighbour = layout->openNeighbour(index, heading);
+            if (neighbour < 0 || pelletDistance[neighbour] <= nextDistance) continue;
+
+            pelletDistance[neighbour] = nextDistance;
+            nearestPelletIndex[neighbour] = nearestPelletIndex[index];
+            searchQueue.push_back(neighbour);
+        }
+    }
 }
 
-void MazeMap::eatPellet(sf::Vector2i tilePos) {
-    if (!isLegalTile(tilePos)) return;
+void MazeMap::addToPelletIndex(const std::vector<int>& pellets) {
+    // Distances only shrink, so a BFS from the new pellets stops wherever an
+    // old pellet is at least as close
+    searchQueue.clear();
+    for (int index : pellets) {
+        pelletDistance[index] = 0;
+        nearestPelletIndex[index] = index;
+        searchQueue.push_back(index);
+    }
 
-    int tileIndex = convert2DCoords(tilePos);
+    for (std::size_t head = 0; head < searchQueue.size(); ++head) {
+        int index = searchQueue[head];
+        int nextDistance = pelletDistance[index] + 1;
 
-    pelletEaten[tileIndex] = true;
+        for (int heading = 0; heading < 4; ++heading) {
+            int neighbour = layout->openNeighbour(index, heading);
+            if (neighbour < 0 || pelletDistance[neighbour] <= nextDistance) continue;
 
-    sf::Vertex* triangles = &pelletVertices[tileIndex * 6];
-    for (int i = 0; i < 6; ++i) {
-        triangles[i].color = sf::Color::Transparent;
+            pelletDistance[neighbour] = nextDistance;
+            nearestPelletIndex[neighbour] = nearestPelletIndex[index];
+            searchQueue.push_back(neighbour);
+        }
+    }
+}
+
+void MazeMap::refillPellets() {
+    if (!layout) return;
+
+    std::fill(eatenBits.begin(), eatenBits.end(), 0);
+    remainingPellets = layout->getPelletCount();
+    dirtyTiles.clear();
+
+    for (auto& [index, chunk] : chunkCache) {
+        chunk.pelletsDirty = true;
+    }
+
+    pelletIndexBuilt = false;
+}
+
+void MazeMap::restoreEatenPellets(const PelletBits& eaten) {
+    if (eaten.size() != eatenBits.size() || eaten == eatenBits) return;
+
+    // Eaten bits are only ever set on pellet tiles, so the count follows from them
+    unsigned int eatenCount = 0;
+    restoredPellets.clear();
+    newlyEatenPellets.clear();
+    for (std::size_t word = 0; word < eaten.size(); ++word) {
+        eatenCount += static_cast<unsigned int>(std::bitset<64>(eaten[word]).count());
+
+        // Walk only the bits that differ
+        for (std::uint64_t changed = eaten[word] ^ eatenBits[word]; changed != 0; changed &= changed - 1) {
+            std::size_t bit = 0;
+            while (!((changed >> bit) & 1)) bit++;
+
+            std::size_t index = word * 64 + bit;
+            markTileDirty({static_cast<int>(index % width), static_cast<int>(index / width)});
+            (((eaten[word] >> bit) & 1) ? newlyEatenPellets : restoredPellets).push_back(static_cast<int>(index));
+        }
+    }
+
+    eatenBits = eaten;
+    remainingPellets = layout->getPelletCount() - eatenCount;
+
+    // The index is repaired like for eatPellet(), rather than rebuilt, so a
+    // rollback of a few ticks only touches the regions around a few pellets.
+    // Restored pellets go in first and leave the eaten ones smaller regions.
+    if (!pelletIndexBuilt) return;
+    addToPelletIndex(restoredPellets);
+    for (int index : newlyEatenPellets) {
+        removeFromPelletIndex(index);
     }
 }
 
@@ -93,7 +214,7 @@ bool MazeMap::hasPellet(sf::Vector2i tilePos) const {
 
     int tileIndex = convert2DCoords(tilePos);
 
-    return !pelletEaten[tileIndex] && pelletMap[tileIndex] > 0;
+    return layout->getPellet(tileIndex) > 0 && !isEaten(tileIndex);
 }
 
 //bool MazeMap::hasPellet(int x, int y) const {
@@ -106,7 +227,7 @@ bool MazeMap::hasPellet(sf::Vector2i tilePos) const {
 
 PelletType MazeMap::getPelletType(sf::Vector2i tilePos) const {
     int tileIndex = tilePos.x + tilePos.y * width;
-    int pellet = pelletMap[tileIndex];
+    int pellet = layout->getPellet(tileIndex);
 
     if (pellet == 1) return PelletType::DOT;
     if (pellet == 2) return PelletType::ENERGIZER;
@@ -117,9 +238,7 @@ PelletType MazeMap::getPelletType(sf::Vector2i tilePos) const {
 bool MazeMap::isWall(sf::Vector2i tilePos) const {
     if (!isLegalTile(tilePos)) return true;
 
-    int tileIndex = convert2DCoords(tilePos);
-
-    return collisionMap[tileIndex] == 1;
+    return layout->isWall(convert2DCoords(tilePos));
 }
 
 //bool MazeMap::isWall(int x, int y) const {
@@ -157,18 +276,269 @@ bool MazeMap::isIntersectionTile(sf::Vector2i tilePos) const {
 };
 
 void MazeMap::draw(sf::RenderTarget& target, sf::RenderStates states) const {
-    if (!texture || !baseMazeSprite.has_value()) return;
+    lastDrawCalls = 0;
+    if (!texture || width == 0) return;
+
+    states.transform *= getTransform();
+    drawFrame++;
+
+    // Visible tile range from the target's view (the map is assumed to sit at 0,0)
+    const sf::View& view = target.getView();
+    sf::Vector2f viewTopLeft = view.getCenter() - view.getSize() / 2.0f;
+    sf::Vector2f viewBottomRight = view.getCenter() + view.getSize() / 2.0f;
+
+    float chunkPixels = static_cast<float>(CHUNK_TILES * tileSize);
+    unsigned int chunksX = (width + CHUNK_TILES - 1) / CHUNK_TILES;
+    unsigned int chunksY = (height + CHUNK_TILES - 1) / CHUNK_TILES;
+
+    auto firstChunk = [chunkPixels](float pixel, unsigned int chunkCount) {
+        return static_cast<unsigned int>(std::clamp(std::floor(pixel / chunkPixels), 0.0f, static_cast<float>(chunkCount)));
+    };
+    auto endChunk = [chunkPixels](float pixel, unsigned int chunkCount) {
+        return static_cast<unsigned int>(std::clamp(std::ceil(pixel / chunkPixels), 0.0f, static_cast<float>(chunkCount)));
+    };
+
+    unsigned int startX = firstChunk(viewTopLeft.x, chunksX);
+    unsigned int startY = firstChunk(viewTopLeft.y, chunksY);
+    unsigned int endX = endChunk(viewBottomRight.x, chunksX);
+    unsigned int endY = endChunk(viewBottomRight.y, chunksY);
+
+    sf::RenderStates baseStates = states;
+    baseStates.texture = baseMazeTexPos.has_value() ? texture : nullptr;
+    sf::RenderStates pelletStates = states;
+    pelletStates.texture = texture;
+
+    std::size_t visibleChunks = 0;
+    for (unsigned int chunkY = startY; chunkY < endY; ++chunkY) {
+        for (unsigned int chunkX = startX; chunkX < endX; ++chunkX) {
+            Chunk& chunk = getChunk({chunkX, chunkY});
+            visibleChunks++;
+
+            if (chunk.baseVertices.getVertexCount() > 0) {
+                target.draw(chunk.baseVertices, baseStates);
+                lastDrawCalls++;
+            }
+            if (chunk.pelletVertices.getVertexCount() > 0) {
+                target.draw(chunk.pelletVertices, pelletStates);
+                lastDrawCalls++;
+            }
+        }
+    }
+
+    evictChunks(visibleChunks);
+}
+
+MazeMap::Chunk& MazeMap::getChunk(sf::Vector2u chunkCoords) const {
+    unsigned int chunksX = (width + CHUNK_TILES - 1) / CHUNK_TILES;
+    auto [it, inserted] = chunkCache.try_emplace(chunkCoords.y * chunksX + chunkCoords.x);
+    Chunk& chunk = it->second;
+
+    if (inserted) {
+        buildChunkBase(chunkCoords, chunk);
+        chunk.pelletsDirty = true;
+    }
+    if (chunk.pelletsDirty) {
+        buildChunkPellets(chunkCoords, chunk);
+        chunk.pelletsDirty = false;
+    }
+
+    chunk.lastUsedFrame = drawFrame;
+    return chunk;
+}
+
+void MazeMap::buildChunkBase(sf::Vector2u chunkCoords, Chunk& chunk) const {
+    chunk.baseVertices.setPrimitiveType(sf::PrimitiveType::Triangles);
+    chunk.baseVertices.clear();
+
+    unsigned int endX = std::min(width, (chunkCoords.x + 1) * CHUNK_TILES);
+    unsigned int endY = std::min(height, (chunkCoords.y + 1) * CHUNK_TILES);
+
+    for (unsigned int y = chunkCoords.y * CHUNK_TILES; y < endY; ++y) {
+        for (unsigned int x = chunkCoords.x * CHUNK_TILES; x < endX; ++x) {
+            sf::Vector2i tilePos(x, y);
+            if (baseMazeTexPos.has_value()) {
+                appendTileQuad(chunk.baseVertices, tilePos, getBaseTexCoords(tilePos), sf::Color::White);
+            } else if (isWall(tilePos)) {
+                appendTileQuad(chunk.baseVertices, tilePos, {0.0f, 0.0f}, FLAT_WALL_COLOR);
+            }
+        }
+    }
+}
+
+void MazeMap::buildChunkPellets(sf::Vector2u chunkCoords, Chunk& chunk) const {
+    chunk.pelletVertices.setPrimitiveType(sf::PrimitiveType::Triangles);
+    chunk.pelletVertices.clear();
+
+    unsigned int endX = std::min(width, (chunkCoords.x + 1) * CHUNK_TILES);
+    unsigned int endY = std::min(height, (chunkCoords.y + 1) * CHUNK_TILES);
+
+    for (unsigned int y = chunkCoords.y * CHUNK_TILES; y < endY; ++y) {
+        for (unsigned int x = chunkCoords.x * CHUNK_TILES; x < endX; ++x) {
+            sf::Vector2i tilePos(x, y);
+            if (hasPellet(tilePos)) {
+                appendTileQuad(chunk.pelletVertices, tilePos, getPelletTexCoords(tilePos), sf::Color::White);
+            }
+        }
+    }
+}
+
+void MazeMap::evictChunks(std::size_t visibleChunks) const {
+    // Keep a margin of recently seen chunks so scrolling back is free
+    std::size_t maxCachedChunks = std::max<std::size_t>(64, visibleChunks * 4);
+    if (chunkCache.size() <= maxCachedChunks) return;
+
+    for (auto it = chunkCache.begin(); it != chunkCache.end();) {
+        if (it->second.lastUsedFrame != drawFrame) {
+            it = chunkCache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void MazeMap::appendTileQuad(sf::VertexArray& vertices, sf::Vector2i tilePos, sf::Vector2f texTopLeft, sf::Color color) const {
+    float left = static_cast<float>(tilePos.x * tileSize);
+    float top = static_cast<float>(tilePos.y * tileSize);
+    float size = static_cast<float>(tileSize);
+
+    vertices.append(sf::Vertex{{left, top}, color, texTopLeft});
+    vertices.append(sf::Vertex{{left + size, top}, color, {texTopLeft.x + size, texTopLeft.y}});
+    vertices.append(sf::Vertex{{left, top + size}, color, {texTopLeft.x, texTopLeft.y + size}});
+    vertices.append(sf::Vertex{{left, top + size}, color, {texTopLeft.x, texTopLeft.y + size}});
+    vertices.append(sf::Vertex{{left + size, top}, color, {texTopLeft.x + size, texTopLeft.y}});
+    vertices.append(sf::Vertex{{left + size, top + size}, color, {texTopLeft.x + size, texTopLeft.y + size}});
+}
+
+sf::Vector2f MazeMap::getBaseTexCoords(sf::Vector2i tilePos) const {
+    sf::Vector2u base = baseMazeTexPos.value_or(sf::Vector2u(0, 0));
+    return {static_cast<float>(base.x + tilePos.x * tileSize),
+            static_cast<float>(base.y + tilePos.y * tileSize)};
+}
+
+sf::Vector2f MazeMap::getPelletTexCoords(sf::Vector2i tilePos) const {
+    // With a matching maze image every tile has its own pellet image; otherwise
+    // borrow the classic maze's top-left dot (1, 1) and energizer (1, 3)
+    sf::Vector2i sourceTile = tilePos;
+    if (!baseMazeTexPos.has_value()) {
+        sourceTile = getPelletType(tilePos) == PelletType::ENERGIZER ? sf::Vector2i(1, 3) : sf::Vector2i(1, 1);
+    }
+
+    return {static_cast<float>(pelletMazeTexPos.x + sourceTile.x * tileSize),
+            static_cast<float>(pelletMazeTexPos.y + sourceTile.y * tileSize)};
+}
+
+sf::Vector2i MazeMap::findNearestOpenTile(sf::Vector2i tilePos) const {
+    int maxRadius = static_cast<int>(std::max(width, height));
 
+    for (int radius = 0; radius <= maxRadius; ++radius) {
+        for (int dy = -radius; dy <= radius; ++dy) {
+            for (int dx = -radius; dx <= radius; ++dx) {
+                if (std::max(std::abs(dx), std::abs(dy)) != radius) continue;
+
+                sf::Vector2i candidate(tilePos.x + dx, tilePos.y + dy);
+                if (isLegalTile(candidate) && !isWall(candidate)) {
+                    return candidate;
+                }
+            }
+        }
+    }
+
+    return tilePos;
+}
+
+void MazeMap::drawSoftware(SoftwareRenderer& renderer) const {
+    if (width == 0) return;
+
+    // Visible tile range, like draw() picks chunks (the map is assumed to sit at 0,0)
+    sf::Vector2f viewTopLeft = renderer.getViewTopLeft();
+    sf::Vector2f viewBottomRight = viewTopLeft + sf::Vector2f(renderer.getViewSize());
+    float tilePixels = static_cast<float>(tileSize);
+
+    auto firstTile = [tilePixels](float pixel, unsigned int tileCount) {
+        return static_cast<unsigned int>(std::clamp(std::floor(pixel / tilePixels), 0.0f, static_cast<float>(tileCount)));
+    };
+    auto endTile = [tilePixels](float pixel, unsigned int tileCount) {
+        return static_cast<unsigned int>(std::clamp(std::ceil(pixel / tilePixels), 0.0f, static_cast<float>(tileCount)));
+    };
+
+    unsigned int startX = firstTile(viewTopLeft.x, width);
+    unsigned int startY = firstTile(viewTopLeft.y, height);
+    unsigned int endX = endTile(viewBottomRight.x, width);
+    unsigned int endY = endTile(viewBottomRight.y, height);
+
+    const sf::Vector2i tileExtent(static_cast<int>(tileSize), static_cast<int>(tileSize));
+
+    // Tiles never overlap, so base then pellet per tile matches draw()'s base
+    // then pellet per chunk
+    for (unsigned int y = startY; y < endY; ++y) {
+        for (unsigned int x = startX; x < endX; ++x) {
+            sf::Vector2i tilePos(x, y);
+            sf::Vector2f topLeft(static_cast<float>(x * tileSize), static_cast<float>(y * tileSize));
+
+            if (baseMazeTexPos.has_value()) {
+                renderer.blit({sf::Vector2i(getBaseTexCoords(tilePos)), tileExtent}, topLeft);
+            } else if (isWall(tilePos)) {
+                renderer.fill({topLeft, {tilePixels, tilePixels}}, FLAT_WALL_COLOR);
+            }
+
+            if (hasPellet(tilePos)) {
+                renderer.blit({sf::Vector2i(getPelletTexCoords(tilePos)), tileExtent}, topLeft);
+            }
+        }
+    }
+}
+
+unsigned int MazeMap::redrawDirtyTiles(sf::RenderTarget& target) {
+    if (!texture || dirtyTiles.empty()) return 0;
+
+    sf::RenderStates states;
     states.transform *= getTransform();
+    dirtyTileVertices.setPrimitiveType(sf::PrimitiveType::Triangles);
+    unsigned int drawCalls = 0;
+
+    // Pass 1: reset each dirty tile to the opaque clear colour, matching a fresh frame
+    dirtyTileVertices.clear();
+    for (const sf::Vector2i& tile : dirtyTiles) {
+        bool flatWall = !baseMazeTexPos.has_value() && isWall(tile);
+        appendTileQuad(dirtyTileVertices, tile, {0.0f, 0.0f}, flatWall ? FLAT_WALL_COLOR : sf::Color::Black);
+    }
+
+    states.blendMode = sf::BlendNone;
+    target.draw(dirtyTileVertices, states);
+    drawCalls++;
+
+    // Pass 2: the base maze tile, then the pellet if one is still there
+    states.blendMode = sf::BlendAlpha;
     states.texture = texture;
 
-    target.draw(*baseMazeSprite, states);
+    if (baseMazeTexPos.has_value()) {
+        dirtyTileVertices.clear();
+        for (const sf::Vector2i& tile : dirtyTiles) {
+            appendTileQuad(dirtyTileVertices, tile, getBaseTexCoords(tile), sf::Color::White);
+        }
+
+        target.draw(dirtyTileVertices, states);
+        drawCalls++;
+    }
 
-    target.draw(pelletVertices, states);
+    dirtyTileVertices.clear();
+    for (const sf::Vector2i& tile : dirtyTiles) {
+        if (hasPellet(tile)) {
+            appendTileQuad(dirtyTileVertices, tile, getPelletTexCoords(tile), sf::Color::White);
+        }
+    }
+
+    if (dirtyTileVertices.getVertexCount() > 0) {
+        target.draw(dirtyTileVertices, states);
+        drawCalls++;
+    }
+
+    dirtyTiles.clear();
+    return drawCalls;
 }
 
 // assumes maze is drawn at 0,0
-sf::Vector2i MazeMap::getTileCoords(sf::Vector2f screenPos) {
+sf::Vector2i MazeMap::getTileCoords(sf::Vector2f screenPos) const {
     int tileX = static_cast<int>(screenPos.x / tileSize);
     int tileY = static_cast<int>(screenPos.y / tileSize);
 
@@ -185,14 +555,14 @@ bool MazeMap::isEntityCentered(const Entity& entity) const {
     sf::Vector2f pos = entity.getPosition();
     float halfTile = tileSize / 2.0f;
 
-    sf::Vector2i tileCoords = const_cast<MazeMap*>(this)->getTileCoords(pos);
+    sf::Vector2i tileCoords = getTileCoords(pos);
     sf::Vector2f tileCenter(tileCoords.x * tileSize + halfTile,
                              tileCoords.y * tileSize + halfTile);
 
     float dx = std::abs(pos.x - tileCenter.x);
     float dy = std::abs(pos.y - tileCenter.y);
 
-    return dx < 1.0f && dy < 1.0f;
+    return dx < getCentreTolerance() && dy < getCentreTolerance();
 }
 
 void MazeMap::snapEntityToGrid(Entity& entity) {
@@ -213,13 +583,13 @@ bool MazeMap::entityCanMove(Entity& entity, MovementDir dir) {
     if (dir == MovementDir::UP || dir == MovementDir::DOWN) {
         float halfTile = tileSize / 2.0f;
         float tileCenterX = currentTile.x * tileSize + halfTile;
-        if (std::abs(currentPos.x - tileCenterX) > 1.0f) {
+        if (std::abs(currentPos.x - tileCenterX) > getCentreTolerance()) {
             return false;
         }
     } else if (dir == MovementDir::LEFT || dir == MovementDir::RIGHT) {
         float halfTile = tileSize / 2.0f;
         float tileCenterY = currentTile.y * tileSize + halfTile;
-        if (std::abs(currentPos.y - tileCenterY) > 1.0f) {
+        if (std::abs(currentPos.y - tileCenterY) > getCentreTolerance()) {
             return false;
         }
     }
@@ -275,3 +645,93 @@ float MazeMap::distanceBetweenTiles(sf::Vector2i t1, sf::Vector2i t2) {
 
     return distance;
 };
+
+void MazeMap::updatePacmanDistanceField(sf::Vector2i pacmanTile) {
+    if (pacmanDistanceSource == pacmanTile) return;
+    pacmanDistanceSource = pacmanTile;
+
+    pacmanDistance.assign(layout ? layout->getTileCount() : 0, UNREACHABLE);
+    if (isWall(pacmanTile)) return;
+
+    // Breadth-first over open tiles; the queue is a plain vector read front to back
+    searchQueue.clear();
+    searchQueue.push_back(convert2DCoords(pacmanTile));
+    pacmanDistance[searchQueue.front()] = 0;
+
+    for (std::size_t head = 0; head < searchQueue.size(); ++head) {
+        int index = searchQueue[head];
+        int nextDistance = pacmanDistance[index] + 1;
+
+        for (int heading = 0; heading < 4; ++heading) {
+            int neighbour = layout->openNeighbour(index, heading);
+            if (neighbour < 0 || pacmanDistance[neighbour] != UNREACHABLE) continue;
+
+            pacmanDistance[neighbour] = nextDistance;
+            searchQueue.push_back(neighbour);
+        }
+    }
+}
+
+int MazeMap::getPacmanDistance(sf::Vector2i tilePos) const {
+    int index = wrappedIndex(tilePos);
+    return index < 0 || pacmanDistance.empty() ? UNREACHABLE : pacmanDistance[index];
+}
+
+std::optional<sf::Vector2i> MazeMap::nearestPellet(sf::Vector2i tilePos) const {
+    int index = wrappedIndex(tilePos);
+    if (index < 0) return std::nullopt;
+
+    ensurePelletIndex();
+    if (nearestPelletIndex[index] < 0) return std::nullopt;
+
+    int pellet = nearestPelletIndex[index];
+    return sf::Vector2i(pellet % static_cast<int>(width), pellet / static_cast<int>(width));
+}
+
+int MazeMap::getPelletDistance(sf::Vector2i tilePos) const {
+    int index = wrappedIndex(tilePos);
+    if (index < 0) return UNREACHABLE;
+
+    ensurePelletIndex();
+    return pelletDistance[index];
+}
+
+int MazeMap::wrappedIndex(sf::Vector2i tilePos) const {
+    if (width == 0 || tilePos.y < 0 || tilePos.y >= static_cast<int>(height)) return -1;
+
+    int w = static_cast<int>(width);
+    tilePos.x = ((tilePos.x % w) + w) % w;
+    return convert2DCoords(tilePos);
+}
+
+void MazeMap::ensurePelletIndex() const {
+    if (pelletIndexBuilt) return;
+    pelletIndexBuilt = true;
+
+    std::size_t tileCount = layout->getTileCount();
+    pelletDistance.assign(tileCount, UNREACHABLE);
+    nearestPelletIndex.assign(tileCount, -1);
+
+    searchQueue.clear();
+    for (std::size_t index = 0; index < tileCount; ++index) {
+        if (layout->getPellet(static_cast<int>(index)) > 0 && !isEaten(index)) {
+            pelletDistance[index] = 0;
+            nearestPelletIndex[index] = static_cast<int>(index);
+            searchQueue.push_back(static_cast<int>(index));
+        }
+    }
+
+    for (std::size_t head = 0; head < searchQueue.size(); ++head) {
+        int index = searchQueue[head];
+        int nextDistance = pelletDistance[index] + 1;
+
+        for (int heading = 0; heading < 4; ++heading) {
+            int neighbour = layout->openNeighbour(index, heading);
+            if (neighbour < 0 || pelletDistance[neighbour] != UNREACHABLE) continue;
+
+            pelletDistance[neighbour] = nextDistance;
+            nearestPelletIndex[neighbour] = nearestPelletIndex[index];
+            searchQueue.push_back(neighbour);
+        }
+    }
+}
@@ -4,10 +4,19 @@
 #include <SFML/Graphics.hpp>
 
 #include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <filesystem>
 
+#include "MazeLayout.h"
+
 class Entity;
+class SoftwareRenderer;
 enum class MovementDir;
 
 enum class PelletType {
@@ -18,18 +27,45 @@ enum class PelletType {
 
 class MazeMap : public sf::Drawable, public sf::Transformable {
 public:
-    MazeMap() : width(28), height(31), tileSize(8), texture(nullptr), baseMazeSprite(std::nullopt) {}
+    // Maze geometry is built and drawn in square chunks of this many tiles
+    static constexpr unsigned int CHUNK_TILES = 16;
+
+    // Wall colour used when no pre-drawn maze image matches the maze
+    static inline const sf::Color FLAT_WALL_COLOR{33, 33, 222};
+
+    MazeMap() : texture(nullptr), width(0), height(0), tileSize(8) {}
 
-    bool loadMaze(const std::vector<int>& collisionData,
-                  const std::vector<int>& pelletData,
+    // One bit per tile, set once its pellet is eaten
+    using PelletBits = std::vector<std::uint64_t>;
+
+    // Plays on a shared layout, so many maps of one maze only differ in their
+    // eaten pellets. baseMazeTexturePos points at a pre-drawn maze image of
+    // exactly the layout's size; without one, walls are drawn as flat quads and
+    // pellets use the dot/energizer tiles of the classic pellet image at
+    // pelletMazeTexturePos. Returns false for a null layout.
+    bool loadMaze(std::shared_ptr<const MazeLayout> sharedLayout,
                   sf::Texture& sharedTexture,
                   unsigned int tileSize,
-                  sf::Vector2u baseMazeTexturePos,
+                  std::optional<sf::Vector2u> baseMazeTexturePos,
                   sf::Vector2u pelletMazeTexturePos);
 
     //void eatPellet(int x, int y);
+    // Also repairs the nearest-pellet index, touching only the tiles that were
+    // closest to this pellet
     void eatPellet(sf::Vector2i tilePos);
 
+    // Puts back every pellet, e.g. for the next level
+    void refillPellets();
+
+    // Eaten state of every tile, for saving and restoring the simulation
+    const PelletBits& getEatenPellets() const { return eatenBits; }
+
+    // Only the tiles that differ are marked for redraw and repaired in the
+    // nearest-pellet index
+    void restoreEatenPellets(const PelletBits& eaten);
+
+    const std::shared_ptr<const MazeLayout>& getLayout() const { return layout; }
+
     //bool hasPellet(int x, int y) const;
     bool hasPellet(sf::Vector2i tilePos) const;
 
@@ -48,7 +84,7 @@ public:
 
     sf::Vector2f getTargetTileCenter(sf::Vector2i tileCoords) const;
 
-    sf::Vector2i getTileCoords(sf::Vector2f screenPos);
+    sf::Vector2i getTileCoords(sf::Vector2f screenPos) const;
 
     bool isEntityCentered(const Entity& entity) const;
 
@@ -64,22 +100,122 @@ public:
     unsigned int getHeight() const { return height; }
     unsigned int getTileSize() const { return tileSize; }
 
+    // How far off a tile centre, in pixels, still counts as on it: 1 pixel of
+    // the 24-pixel tiles the movement rules were tuned on, whatever tileSize is
+    float getCentreTolerance() const { return tileSize / 24.0f; }
+
+    // Draw calls issued by the last draw(): two per visible chunk
+    unsigned int getDrawCallCount() const { return lastDrawCalls; }
+
+    // Nearest non-wall tile to tilePos (by ring distance), or tilePos if the maze has none
+    sf::Vector2i findNearestOpenTile(sf::Vector2i tilePos) const;
+
+    // Repaints only the tiles changed since the last call (eaten pellets) onto a
+    // target that already holds a full draw() of this map. Returns the draw calls issued.
+    unsigned int redrawDirtyTiles(sf::RenderTarget& target);
+
+    // Forget pending dirty tiles after a full redraw, and start recording them:
+    // until the first call, e.g. on maps that are never drawn, none are kept
+    void clearDirtyTiles() {
+        dirtyTiles.clear();
+        tracksDirtyTiles = true;
+    }
+
+    // What draw() puts on screen, drawn on the CPU for the tiles in the
+    // renderer's view; the atlas set on renderer must match the map's texture
+    void drawSoftware(SoftwareRenderer& renderer) const;
+
+    static constexpr int UNREACHABLE = std::numeric_limits<int>::max();
+
+    // Rebuilds the maze-distance field around Pac-Man, but only when pacmanTile
+    // differs from the tile it was last built from. Every ghost reads the same field.
+    // A full BFS rather than an incremental repair: one step can change the distance
+    // of every tile anyway, and --stress prints what a rebuild costs per tick.
+    void updatePacmanDistanceField(sf::Vector2i pacmanTile);
+
+    // Moves from tilePos to Pac-Man through open tiles and wrap-around tunnels;
+    // UNREACHABLE for walls and tiles cut off from him. x wraps like the tunnels.
+    int getPacmanDistance(sf::Vector2i tilePos) const;
+
+    // Closest uneaten pellet by maze distance, or nullopt when none can be reached.
+    // The index behind it is built on the first query and then kept up to date.
+    std::optional<sf::Vector2i> nearestPellet(sf::Vector2i tilePos) const;
+
+    // Moves from tilePos to nearestPellet(tilePos), or UNREACHABLE
+    int getPelletDistance(sf::Vector2i tilePos) const;
+
+    // Uneaten dots and energizers; zero once the level is cleared
+    unsigned int dotsRemaining() const { return remainingPellets; }
+
 private:
     void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 
-    std::vector<int> collisionMap;  // 1=wall, 0=path
-    std::vector<int> pelletMap;     // 0=none, 1=pellet, 2=power pellet
-    std::vector<bool> pelletEaten;
+    struct Chunk {
+        sf::VertexArray baseVertices;    // maze image tiles, or flat wall quads
+        sf::VertexArray pelletVertices;  // uneaten pellets only
+        bool pelletsDirty = false;
+        unsigned long lastUsedFrame = 0;
+    };
+
+    // Chunk meshes are built on first sight and evicted once off screen, so
+    // geometry memory follows the viewport rather than the maze area
+    Chunk& getChunk(sf::Vector2u chunkCoords) const;
+    void buildChunkBase(sf::Vector2u chunkCoords, Chunk& chunk) const;
+    void buildChunkPellets(sf::Vector2u chunkCoords, Chunk& chunk) const;
+    void evictChunks(std::size_t visibleChunks) const;
+
+    // Wrapped index of tilePos, or -1 off the top or bottom edge
+    int wrappedIndex(sf::Vector2i tilePos) const;
+
+    bool isEaten(std::size_t index) const { return (eatenBits[index / 64] >> (index % 64)) & 1; }
+
+    // Multi-source BFS from every uneaten pellet, unless already built
+    void ensurePelletIndex() const;
+
+    // Index repairs: after tileIndex's pellet is gone, and after the given
+    // pellets are back. Each only searches the tiles whose nearest pellet changes.
+    void removeFromPelletIndex(int tileIndex);
+    void addToPelletIndex(const std::vector<int>& pellets);
+
+    void markTileDirty(sf::Vector2i tilePos);
+
+    void appendTileQuad(sf::VertexArray& vertices, sf::Vector2i tilePos, sf::Vector2f texTopLeft, sf::Color color) const;
+    sf::Vector2f getBaseTexCoords(sf::Vector2i tilePos) const;
+    sf::Vector2f getPelletTexCoords(sf::Vector2i tilePos) const;
+
+    std::shared_ptr<const MazeLayout> layout;
+    PelletBits eatenBits;
+    unsigned int remainingPellets = 0;
+
+    mutable std::unordered_map<unsigned int, Chunk> chunkCache;
+    mutable unsigned long drawFrame = 0;
+    mutable unsigned int lastDrawCalls = 0;
+
+    std::vector<sf::Vector2i> dirtyTiles;
+    bool tracksDirtyTiles = false;
+    sf::VertexArray dirtyTileVertices;
+
+    // Search state is allocated on first use, so maps nobody queries stay small
+    std::vector<int> pacmanDistance;
+    mutable std::vector<int> searchQueue;  // tile indices, reused between searches
+    std::optional<sf::Vector2i> pacmanDistanceSource;
+
+    // Maze-distance Voronoi of the uneaten pellets: every open tile's distance
+    // to, and tile index of, its nearest pellet (-1 for none)
+    mutable std::vector<int> pelletDistance;
+    mutable std::vector<int> nearestPelletIndex;
+    mutable bool pelletIndexBuilt = false;
+    std::vector<std::pair<int, int>> repairSeeds;  // (distance, tile index)
+    std::vector<int> restoredPellets;              // tile indices, reused between restores
+    std::vector<int> newlyEatenPellets;
 
-    std::optional<sf::Sprite> baseMazeSprite;
-    sf::VertexArray pelletVertices;
     sf::Texture* texture;
 
     unsigned int width;
     unsigned int height;
     unsigned int tileSize;
 
-    sf::Vector2u baseMazeTexPos;
+    std::optional<sf::Vector2u> baseMazeTexPos;
     sf::Vector2u pelletMazeTexPos;
 };
 
@@ -0,0 +1,113 @@
+#include "Metrics.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <nlohmann/json.hpp>
+
+Metrics::Histogram::Histogram(std::vector<double> bounds) :
+    upperBounds(std::move(bounds)),
+    bucketCounts(new std::atomic<std::uint64_t>[upperBounds.size() + 1])
+{
+    std::sort(upperBounds.begin(), upperBounds.end());
+    for (std::size_t bucket = 0; bucket <= upperBounds.size(); ++bucket) {
+        bucketCounts[bucket].store(0, std::memory_order_relaxed);
+    }
+}
+
+void Metrics::Histogram::observe(double sample) {
+    std::size_t bucket = std::lower_bound(upperBounds.begin(), upperBounds.end(), sample) - upperBounds.begin();
+    bucketCounts[bucket].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+
+    double previous = sum.load(std::memory_order_relaxed);
+    while (!sum.compare_exchange_weak(previous, previous + sample, std::memory_order_relaxed)) {
+    }
+}
+
+Metrics::Counter& Metrics::addCounter(const std::string& name, const std::string& help, const std::string& labels) {
+    Counter& counter = counters.emplace_back();
+    series.push_back({name, help, labels, &counter, nullptr, nullptr});
+    return counter;
+}
+
+Metrics::Gauge& Metrics::addGauge(const std::string& name, const std::string& help, const std::string& labels) {
+    Gauge& gauge = gauges.emplace_back();
+    series.push_back({name, help, labels, nullptr, &gauge, nullptr});
+    return gauge;
+}
+
+Metrics::Histogram& Metrics::addHistogram(const std::string& name, const std::string& help, std::vector<double> upperBounds) {
+    Histogram& histogram = histograms.emplace_back(std::move(upperBounds));
+    series.push_back({name, help, "", nullptr, nullptr, &histogram});
+    return histogram;
+}
+
+// 15 significant digits, so bounds like 0.004 print as written
+static std::string formatValue(double value) {
+    std::ostringstream text;
+    text << std::setprecision(15) << value;
+    return text.str();
+}
+
+void Metrics::writePrometheus(std::ostream& out) const {
+    const std::string* previousName = nullptr;
+
+    for (const Series& entry : series) {
+        if (!previousName || *previousName != entry.name) {
+            const char* type = entry.counter ? "counter" : entry.gauge ? "gauge" : "histogram";
+            out << "# HELP " << entry.name << ' ' << entry.help << '\n';
+            out << "# TYPE " << entry.name << ' ' << type << '\n';
+            previousName = &entry.name;
+        }
+
+        std::string labels = entry.labels.empty() ? "" : "{" + entry.labels + "}";
+
+        if (entry.counter) {
+            out << entry.name << labels << ' ' << entry.counter->get() << '\n';
+        } else if (entry.gauge) {
+            out << entry.name << labels << ' ' << formatValue(entry.gauge->get()) << '\n';
+        } else {
+            const Histogram& histogram = *entry.histogram;
+            const std::vector<double>& bounds = histogram.getUpperBounds();
+
+            std::uint64_t cumulative = 0;
+            for (std::size_t bucket = 0; bucket <= bounds.size(); ++bucket) {
+                cumulative += histogram.getBucketCount(bucket);
+                std::string bound = bucket < bounds.size() ? formatValue(bounds[bucket]) : "+Inf";
+                out << entry.name << "_bucket{le=\"" << bound << "\"} " << cumulative << '\n';
+            }
+            out << entry.name << "_sum " << formatValue(histogram.getSum()) << '\n';
+            out << entry.name << "_count " << histogram.getCount() << '\n';
+        }
+    }
+}
+
+void Metrics::writeJsonLine(std::ostream& out, double unixSeconds) const {
+    nlohmann::ordered_json line;
+    line["time"] = unixSeconds;
+
+    for (const Series& entry : series) {
+        std::string key = entry.labels.empty() ? entry.name : entry.name + "{" + entry.labels + "}";
+
+        if (entry.counter) {
+            line[key] = entry.counter->get();
+        } else if (entry.gauge) {
+            line[key] = entry.gauge->get();
+        } else {
+            const Histogram& histogram = *entry.histogram;
+            const std::vector<double>& bounds = histogram.getUpperBounds();
+
+            // Cumulative, like the Prometheus buckets
+            nlohmann::ordered_json buckets = nlohmann::ordered_json::object();
+            std::uint64_t cumulative = 0;
+            for (std::size_t bucket = 0; bucket <= bounds.size(); ++bucket) {
+                cumulative += histogram.getBucketCount(bucket);
+                buckets[bucket < bounds.size() ? formatValue(bounds[bucket]) : "+Inf"] = cumulative;
+            }
+
+            line[key] = {{"count", histogram.getCount()}, {"sum", histogram.getSum()}, {"buckets", buckets}};
+        }
+    }
+
+    out << line.dump() << '\n';
+}
@@ -0,0 +1,88 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Counters, gauges and histograms that the game loop updates and a
+// MetricsExporter reads from its own thread. Every update is a relaxed atomic,
+// so neither side ever waits for the other. Register all metrics before an
+// exporter starts reading; the set is fixed from then on.
+class Metrics {
+public:
+    class Counter {
+    public:
+        void add(std::uint64_t amount = 1) { value.fetch_add(amount, std::memory_order_relaxed); }
+        std::uint64_t get() const { return value.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<std::uint64_t> value{0};
+    };
+
+    class Gauge {
+    public:
+        void set(double newValue) { value.store(newValue, std::memory_order_relaxed); }
+        double get() const { return value.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<double> value{0.0};
+    };
+
+    // Samples counted into buckets by inclusive upper bound, plus one bucket
+    // for everything above the last bound
+    class Histogram {
+    public:
+        explicit Histogram(std::vector<double> upperBounds);
+
+        void observe(double sample);
+
+        const std::vector<double>& getUpperBounds() const { return upperBounds; }
+
+        // Samples in bucket alone (not cumulative); bucket == getUpperBounds().size() is the overflow
+        std::uint64_t getBucketCount(std::size_t bucket) const { return bucketCounts[bucket].load(std::memory_order_relaxed); }
+        std::uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+        double getSum() const { return sum.load(std::memory_order_relaxed); }
+
+    private:
+        std::vector<double> upperBounds;
+        std::unique_ptr<std::atomic<std::uint64_t>[]> bucketCounts;
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<double> sum{0.0};
+    };
+
+    // labels is in Prometheus form, e.g. mode="chase". Series that share a name
+    // must be registered one after another.
+    Counter& addCounter(const std::string& name, const std::string& help, const std::string& labels = "");
+    Gauge& addGauge(const std::string& name, const std::string& help, const std::string& labels = "");
+    Histogram& addHistogram(const std::string& name, const std::string& help, std::vector<double> upperBounds);
+
+    // Prometheus text exposition format
+    void writePrometheus(std::ostream& out) const;
+
+    // One JSON object on one line, keyed by name{labels}, stamped with unixSeconds
+    void writeJsonLine(std::ostream& out, double unixSeconds) const;
+
+private:
+    struct Series {
+        std::string name;
+        std::string help;
+        std::string labels;
+        const Counter* counter = nullptr;
+        const Gauge* gauge = nullptr;
+        const Histogram* histogram = nullptr;
+    };
+
+    // Deques never move their elements, so the references handed out stay valid
+    std::deque<Counter> counters;
+    std::deque<Gauge> gauges;
+    std::deque<Histogram> histograms;
+    std::vector<Series> series;  // in registration order
+};
+
+#endif
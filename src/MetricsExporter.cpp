@@ -0,0 +1,75 @@
+#include "MetricsExporter.h"
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <system_error>
+
+MetricsExporter::MetricsExporter(const Metrics& metrics, const std::filesystem::path& path, Format format, sf::Time interval) :
+    metrics(metrics),
+    path(path),
+    format(format),
+    interval(interval)
+{
+    if (format == Format::JSON_LINES) {
+        jsonLines.open(path, std::ios::app);
+    }
+    if (!writeSnapshot()) {
+        throw std::runtime_error("Could not write metrics to " + path.string());
+    }
+
+    exportThread = std::thread(&MetricsExporter::exportLoop, this);
+}
+
+MetricsExporter::~MetricsExporter() {
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        stopping = true;
+    }
+    stopRequested.notify_all();
+    exportThread.join();
+}
+
+void MetricsExporter::exportLoop() {
+    const auto wait = std::chrono::microseconds(interval.asMicroseconds());
+    bool reportedFailure = false;
+
+    std::unique_lock<std::mutex> lock(stopMutex);
+    while (true) {
+        bool stop = stopRequested.wait_for(lock, wait, [this] { return stopping; });
+
+        // Unlocked while writing; only the destructor ever takes the lock
+        lock.unlock();
+        bool written = writeSnapshot();
+        lock.lock();
+
+        // Reported once per run of failures rather than on every interval
+        if (!written && !reportedFailure) {
+            std::cerr << "Metrics: writing " << path.string() << " failed" << std::endl;
+        }
+        reportedFailure = !written;
+
+        if (stop) return;
+    }
+}
+
+bool MetricsExporter::writeSnapshot() {
+    if (format == Format::JSON_LINES) {
+        double now = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+        metrics.writeJsonLine(jsonLines, now);
+        jsonLines.flush();
+        return jsonLines.good();
+    }
+
+    // Write beside the target and rename over it, so readers never see half a file
+    std::filesystem::path temporary = path;
+    temporary += ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        metrics.writePrometheus(file);
+        if (!file.good()) return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    return !error;
+}
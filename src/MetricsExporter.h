@@ -0,0 +1,49 @@
+#ifndef METRICSEXPORTER_H
+#define METRICSEXPORTER_H
+
+#include <SFML/System/Time.hpp>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include "Metrics.h"
+
+// Writes snapshots of a Metrics registry to a local file on a background
+// thread, so whoever updates the metrics never waits on disk I/O.
+class MetricsExporter {
+public:
+    enum class Format {
+        PROMETHEUS,  // replaced on every write, for a node_exporter textfile collector
+        JSON_LINES   // one line appended per write
+    };
+
+    // Writes the first snapshot before returning; throws if that fails
+    MetricsExporter(const Metrics& metrics, const std::filesystem::path& path, Format format, sf::Time interval);
+
+    // Stops the thread after one last snapshot
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+private:
+    void exportLoop();
+
+    bool writeSnapshot();
+
+    const Metrics& metrics;
+    std::filesystem::path path;
+    Format format;
+    sf::Time interval;
+
+    std::ofstream jsonLines;  // kept open in append mode
+
+    std::mutex stopMutex;
+    std::condition_variable stopRequested;
+    bool stopping = false;
+    std::thread exportThread;
+};
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef NETTRANSPORT_H
+#define NETTRANSPORT_H
+
+#include <vector>
+
+#include "Entity.h"
+
+// One player's input for one simulation tick
+struct InputPacket {
+    long long tick;
+    MovementDir direction;  // held direction, STATIC for none
+};
+
+// Carries input packets between versus-mode peers. Delivery may be late,
+// jittered or out of order; packets carry their tick so rollback can sort it out.
+class NetTransport {
+public:
+    virtual ~NetTransport() = default;
+
+    virtual void send(const InputPacket& packet) = 0;
+
+    // Moves every packet that has arrived into out (cleared first)
+    virtual void receive(std::vector<InputPacket>& out) = 0;
+};
+
+#endif
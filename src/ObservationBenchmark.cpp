@@ -0,0 +1,74 @@
+#include "ObservationBenchmark.h"
+#include "Game.h"
+#include <SFML/System/Clock.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+void ObservationBenchmark::run() {
+    unsigned int workerCount = settings.workerCount > 0 ? settings.workerCount : std::max(1u, std::thread::hardware_concurrency());
+    workerCount = static_cast<unsigned int>(std::min<std::size_t>(workerCount, std::max<std::size_t>(1, settings.gameCount)));
+
+    // One batch for every game's stack, as a trainer would hand over
+    const std::size_t observationBytes = GameObserver::getObservationBytes(settings.observation);
+    std::vector<std::uint8_t> batch(settings.gameCount * observationBytes);
+
+    // Every game draws from the one atlas image and maze layout loaded here
+    game.setHeadless(true);
+    game.loadResources();
+
+    std::vector<std::unique_ptr<Game>> games;
+    std::vector<std::unique_ptr<GameObserver>> observers;
+    for (std::size_t i = 0; i < settings.gameCount; ++i) {
+        Game& observed = *games.emplace_back(std::make_unique<Game>(game.getConfigPath()));
+        observed.shareResources(game);
+        observers.push_back(std::make_unique<GameObserver>(observed, settings.observation, batch.data() + i * observationBytes));
+    }
+
+    std::cout << "Stepping " << settings.gameCount << " games for " << settings.ticksPerGame << " ticks on "
+              << workerCount << " threads: " << settings.observation.stackDepth << " x " << settings.observation.size.x
+              << "x" << settings.observation.size.y << " observations" << std::endl;
+
+    // Worker w steps games w, w + workerCount, ...; a press in a random direction every few dozen ticks
+    auto stepLoop = [&](unsigned int workerIndex) {
+        const MovementDir directions[] = {MovementDir::UP, MovementDir::DOWN, MovementDir::LEFT, MovementDir::RIGHT};
+        std::mt19937_64 random(workerIndex + 1);
+        std::uniform_int_distribution<int> pickDirection(0, 3);
+        std::uniform_int_distribution<int> oneIn(0, 23);
+        std::vector<InputEvent> tickInput;
+        std::vector<MovementDir> held(observers.size(), MovementDir::STATIC);
+
+        for (unsigned int tickIndex = 0; tickIndex < settings.ticksPerGame; ++tickIndex) {
+            for (std::size_t i = workerIndex; i < observers.size(); i += workerCount) {
+                tickInput.clear();
+                if (oneIn(random) == 0) {
+                    if (held[i] != MovementDir::STATIC) tickInput.push_back({held[i], false, sf::Time::Zero});
+                    held[i] = directions[pickDirection(random)];
+                    tickInput.push_back({held[i], true, sf::Time::Zero});
+                }
+                observers[i]->step(tickInput);
+            }
+        }
+    };
+
+    sf::Clock clock;
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < workerCount; ++i) {
+        threads.emplace_back(stepLoop, i);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::max(clock.getElapsedTime().asMicroseconds() / 1e6, 1e-9);
+
+    double observations = static_cast<double>(settings.gameCount) * settings.ticksPerGame;
+    double frameMegabytes = observations * observationBytes / settings.observation.stackDepth / 1e6;
+    std::cout << std::fixed << std::setprecision(1) << observations << " observations in " << seconds << " s ("
+              << observations / seconds << " per second, " << observations / seconds / workerCount << " per thread, "
+              << frameMegabytes / seconds << " MB/s of new frames)" << std::endl;
+}
@@ -0,0 +1,30 @@
+#ifndef OBSERVATIONBENCHMARK_H
+#define OBSERVATIONBENCHMARK_H
+
+#include <cstddef>
+
+#include "GameObserver.h"
+
+class Game;
+
+// Steps gameCount observed copies of a game on random input, every stack in
+// one batch buffer, and reports observations per second
+class ObservationBenchmark {
+public:
+    struct Settings {
+        GameObserver::Settings observation;
+        std::size_t gameCount = 16;
+        unsigned int ticksPerGame = 1000;
+        unsigned int workerCount = 0;    // 0: one per hardware thread
+    };
+
+    ObservationBenchmark(Game& game, const Settings& settings) : game(game), settings(settings) {}
+
+    void run();
+
+private:
+    Game& game;
+    Settings settings;
+};
+
+#endif
@@ -0,0 +1,164 @@
+#include "ObservationEncoder.h"
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// BT.601 weights in 8.8 fixed point; they sum to 256, so white stays 255
+constexpr unsigned int RED_WEIGHT = 77;
+constexpr unsigned int GREEN_WEIGHT = 150;
+constexpr unsigned int BLUE_WEIGHT = 29;
+
+inline std::uint8_t toGray(const std::uint8_t* pixel) {
+    return static_cast<std::uint8_t>((RED_WEIGHT * pixel[0] + GREEN_WEIGHT * pixel[1] + BLUE_WEIGHT * pixel[2] + 128) >> 8);
+}
+
+inline std::uint8_t toRgb332(const std::uint8_t* pixel) {
+    return static_cast<std::uint8_t>((pixel[0] & 0xE0) | ((pixel[1] & 0xE0) >> 3) | (pixel[2] >> 6));
+}
+
+#if defined(__SSE2__)
+// Weighted sums of four RGBA8 pixels in 32-bit lanes
+inline __m128i grayFourPixels(__m128i pixels) {
+    const __m128i weights = _mm_set_epi16(0, BLUE_WEIGHT, GREEN_WEIGHT, RED_WEIGHT, 0, BLUE_WEIGHT, GREEN_WEIGHT, RED_WEIGHT);
+    const __m128i zero = _mm_setzero_si128();
+
+    // (77r + 150g, 29b) pairs per pixel, added across the pair into the even lanes
+    __m128i low = _mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), weights);
+    __m128i high = _mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), weights);
+    low = _mm_add_epi32(low, _mm_srli_epi64(low, 32));
+    high = _mm_add_epi32(high, _mm_srli_epi64(high, 32));
+
+    __m128i sums = _mm_unpacklo_epi64(_mm_shuffle_epi32(low, _MM_SHUFFLE(3, 1, 2, 0)), _mm_shuffle_epi32(high, _MM_SHUFFLE(3, 1, 2, 0)));
+    return _mm_srli_epi32(_mm_add_epi32(sums, _mm_set1_epi32(128)), 8);
+}
+
+// rrrgggbb of four RGBA8 pixels in 32-bit lanes
+inline __m128i rgb332FourPixels(__m128i pixels) {
+    __m128i red = _mm_and_si128(pixels, _mm_set1_epi32(0xE0));
+    __m128i green = _mm_and_si128(_mm_srli_epi32(pixels, 11), _mm_set1_epi32(0x1C));
+    __m128i blue = _mm_and_si128(_mm_srli_epi32(pixels, 22), _mm_set1_epi32(0x03));
+    return _mm_or_si128(red, _mm_or_si128(green, blue));
+}
+#endif
+
+// Splits length source pixels into count runs of as equal a length as possible
+std::vector<unsigned int> boxStarts(unsigned int length, unsigned int count) {
+    std::vector<unsigned int> starts(count + 1);
+    for (unsigned int i = 0; i <= count; ++i) {
+        starts[i] = static_cast<unsigned int>(static_cast<unsigned long long>(i) * length / count);
+    }
+    return starts;
+}
+
+}
+
+ObservationEncoder::ObservationEncoder(sf::Vector2u sourceSize, sf::Vector2u outputSize, Format format)
+    : sourceSize(sourceSize), outputSize(outputSize), format(format) {
+    if (sourceSize.x == 0 || sourceSize.y == 0 || outputSize.x == 0 || outputSize.y == 0) {
+        throw std::runtime_error("Observation sizes must not be zero");
+    }
+    if (outputSize.x > sourceSize.x || outputSize.y > sourceSize.y) {
+        throw std::runtime_error("Observations can only be downsampled");
+    }
+
+    columnStart = boxStarts(sourceSize.x, outputSize.x);
+    rowStart = boxStarts(sourceSize.y, outputSize.y);
+
+    // 16-bit column sums hold up to 257 rows of 255
+    unsigned int rowsPerBox = (sourceSize.y + outputSize.y - 1) / outputSize.y;
+    if (rowsPerBox > 257) {
+        throw std::runtime_error("Observation height is too small for the source frame");
+    }
+
+    minColumns = sourceSize.x / outputSize.x;
+    minRows = sourceSize.y / outputSize.y;
+    for (unsigned int rowStep = 0; rowStep < 2; ++rowStep) {
+        for (unsigned int columnStep = 0; columnStep < 2; ++columnStep) {
+            std::uint64_t boxPixels = static_cast<std::uint64_t>(minRows + rowStep) * (minColumns + columnStep);
+            reciprocals[rowStep * 2 + columnStep] = ((std::uint64_t(1) << RECIPROCAL_SHIFT) + boxPixels - 1) / boxPixels;
+        }
+    }
+
+    columnSums.resize(static_cast<std::size_t>(sourceSize.x) * 4);
+    filteredRow.resize(static_cast<std::size_t>(outputSize.x) * 4);
+}
+
+void ObservationEncoder::encode(const std::uint8_t* source, std::uint8_t* output) {
+    const std::size_t sourceRowBytes = static_cast<std::size_t>(sourceSize.x) * 4;
+
+    if (outputSize == sourceSize) {
+        for (unsigned int y = 0; y < sourceSize.y; ++y) {
+            convertRow(source + y * sourceRowBytes, output + static_cast<std::size_t>(y) * outputSize.x, outputSize.x);
+        }
+        return;
+    }
+
+    for (unsigned int outputY = 0; outputY < outputSize.y; ++outputY) {
+        // Vertical pass: add up every channel of the box's source rows
+        std::fill(columnSums.begin(), columnSums.end(), 0);
+        for (unsigned int y = rowStart[outputY]; y < rowStart[outputY + 1]; ++y) {
+            const std::uint8_t* row = source + y * sourceRowBytes;
+            std::size_t i = 0;
+
+#if defined(__SSE2__)
+            const __m128i zero = _mm_setzero_si128();
+            for (; i + 16 <= sourceRowBytes; i += 16) {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+                __m128i* sums = reinterpret_cast<__m128i*>(&columnSums[i]);
+                _mm_storeu_si128(sums, _mm_add_epi16(_mm_loadu_si128(sums), _mm_unpacklo_epi8(bytes, zero)));
+                _mm_storeu_si128(sums + 1, _mm_add_epi16(_mm_loadu_si128(sums + 1), _mm_unpackhi_epi8(bytes, zero)));
+            }
+#endif
+
+            for (; i < sourceRowBytes; ++i) {
+                columnSums[i] = static_cast<std::uint16_t>(columnSums[i] + row[i]);
+            }
+        }
+
+        // Horizontal pass: average each box, rounding to nearest
+        unsigned int boxRows = rowStart[outputY + 1] - rowStart[outputY];
+        for (unsigned int outputX = 0; outputX < outputSize.x; ++outputX) {
+            unsigned int boxColumns = columnStart[outputX + 1] - columnStart[outputX];
+            unsigned int boxPixels = boxRows * boxColumns;
+            std::uint64_t reciprocal = reciprocals[(boxRows - minRows) * 2 + (boxColumns - minColumns)];
+
+            unsigned int totals[4] = {0, 0, 0, 0};
+            for (unsigned int x = columnStart[outputX]; x < columnStart[outputX + 1]; ++x) {
+                const std::uint16_t* sums = &columnSums[x * 4];
+                for (unsigned int channel = 0; channel < 4; ++channel) {
+                    totals[channel] += sums[channel];
+                }
+            }
+            for (unsigned int channel = 0; channel < 4; ++channel) {
+                filteredRow[outputX * 4 + channel] = static_cast<std::uint8_t>(((totals[channel] + boxPixels / 2) * reciprocal) >> RECIPROCAL_SHIFT);
+            }
+        }
+
+        convertRow(filteredRow.data(), output + static_cast<std::size_t>(outputY) * outputSize.x, outputSize.x);
+    }
+}
+
+void ObservationEncoder::convertRow(const std::uint8_t* source, std::uint8_t* output, unsigned int count) const {
+    unsigned int i = 0;
+
+#if defined(__SSE2__)
+    for (; i + 8 <= count; i += 8) {
+        __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+        __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4 + 16));
+
+        __m128i values = format == Format::GRAYSCALE
+            ? _mm_packs_epi32(grayFourPixels(first), grayFourPixels(second))
+            : _mm_packs_epi32(rgb332FourPixels(first), rgb332FourPixels(second));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(output + i), _mm_packus_epi16(values, values));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        output[i] = format == Format::GRAYSCALE ? toGray(source + i * 4) : toRgb332(source + i * 4);
+    }
+}
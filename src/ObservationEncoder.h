@@ -0,0 +1,55 @@
+#ifndef OBSERVATIONENCODER_H
+#define OBSERVATIONENCODER_H
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Turns an RGBA8 frame into the small one-byte-per-pixel images vision agents
+// train on: box-filtered down to outputSize, then converted to grayscale or a
+// fixed 3-3-2 colour palette. Row conversion and vertical filtering use SSE2
+// where available.
+class ObservationEncoder {
+public:
+    enum class Format {
+        GRAYSCALE,  // BT.601 luma
+        RGB332      // rrrgggbb: 8 reds, 8 greens, 4 blues
+    };
+
+    // Throws if a size is zero or outputSize is larger than sourceSize
+    ObservationEncoder(sf::Vector2u sourceSize, sf::Vector2u outputSize, Format format);
+
+    sf::Vector2u getOutputSize() const { return outputSize; }
+
+    std::size_t getFrameBytes() const { return static_cast<std::size_t>(outputSize.x) * outputSize.y; }
+
+    // Reads sourceSize RGBA8 pixels and writes getFrameBytes() bytes to output
+    void encode(const std::uint8_t* source, std::uint8_t* output);
+
+private:
+    // Converts count RGBA8 pixels to one byte each
+    void convertRow(const std::uint8_t* source, std::uint8_t* output, unsigned int count) const;
+
+    sf::Vector2u sourceSize;
+    sf::Vector2u outputSize;
+    Format format;
+
+    // Source columns and rows [start[i], start[i + 1]) average into output pixel i
+    std::vector<unsigned int> columnStart;
+    std::vector<unsigned int> rowStart;
+
+    // Boxes come in at most two widths and two heights; dividing by one of the
+    // four box sizes is a multiply by reciprocals[height step * 2 + width step]
+    // and a shift. Exact for the sums a box can have.
+    static constexpr unsigned int RECIPROCAL_SHIFT = 48;
+    unsigned int minColumns;
+    unsigned int minRows;
+    std::uint64_t reciprocals[4];
+
+    // Scratch rows, reused between frames
+    std::vector<std::uint16_t> columnSums;  // RGBA channels of one output row's source rows
+    std::vector<std::uint8_t> filteredRow;  // RGBA8 of one output row
+};
+
+#endif
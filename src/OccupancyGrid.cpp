@@ -0,0 +1,58 @@
+#include "OccupancyGrid.h"
+#include <algorithm>
+
+void OccupancyGrid::reset(sf::Vector2u mazeSize, std::size_t slotCount) {
+    size = mazeSize;
+    tileHeads.assign(static_cast<std::size_t>(size.x) * size.y, NONE);
+    nextSlot.assign(slotCount, NONE);
+    previousSlot.assign(slotCount, NONE);
+    slotTile.assign(slotCount, NONE);
+}
+
+int OccupancyGrid::tileIndex(sf::Vector2i tile) const {
+    int width = static_cast<int>(size.x);
+    int x = ((tile.x % width) + width) % width;
+    int y = std::clamp(tile.y, 0, static_cast<int>(size.y) - 1);
+
+    return x + y * width;
+}
+
+void OccupancyGrid::place(unsigned int slot, sf::Vector2i tile) {
+    if (tileHeads.empty()) return;
+
+    int index = tileIndex(tile);
+    if (slotTile[slot] == index) return;
+
+    remove(slot);
+
+    nextSlot[slot] = tileHeads[index];
+    if (tileHeads[index] != NONE) {
+        previousSlot[tileHeads[index]] = slot;
+    }
+    tileHeads[index] = slot;
+    slotTile[slot] = index;
+}
+
+void OccupancyGrid::remove(unsigned int slot) {
+    int index = slotTile[slot];
+    if (index == NONE) return;
+
+    if (previousSlot[slot] != NONE) {
+        nextSlot[previousSlot[slot]] = nextSlot[slot];
+    } else {
+        tileHeads[index] = nextSlot[slot];
+    }
+    if (nextSlot[slot] != NONE) {
+        previousSlot[nextSlot[slot]] = previousSlot[slot];
+    }
+
+    nextSlot[slot] = NONE;
+    previousSlot[slot] = NONE;
+    slotTile[slot] = NONE;
+}
+
+int OccupancyGrid::firstInTile(sf::Vector2i tile) const {
+    if (tileHeads.empty()) return NONE;
+
+    return tileHeads[tileIndex(tile)];
+}
@@ -0,0 +1,48 @@
+#ifndef OCCUPANCYGRID_H
+#define OCCUPANCYGRID_H
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <vector>
+
+// Which entity slots are in each maze tile. Every tile keeps a doubly linked
+// list of its occupants, so moving between tiles is O(1) and finding who shares
+// a tile never scans the other entities.
+class OccupancyGrid {
+public:
+    static constexpr int NONE = -1;
+
+    // Empties the grid for a maze of mazeSize tiles and slots 0 .. slotCount - 1
+    void reset(sf::Vector2u mazeSize, std::size_t slotCount);
+
+    // Inserts slot into tile, or moves it there from its current tile.
+    // Tiles off the maze edge are wrapped horizontally and clamped vertically
+    void place(unsigned int slot, sf::Vector2i tile);
+
+    void remove(unsigned int slot);
+
+    int firstInTile(sf::Vector2i tile) const;
+    int nextInTile(unsigned int slot) const { return nextSlot[slot]; }
+
+    // visit(slot) for every occupant of tile; visit may move the slot it is given
+    template <typename Visit>
+    void forEachInTile(sf::Vector2i tile, Visit&& visit) const {
+        for (int slot = firstInTile(tile); slot != NONE;) {
+            int next = nextSlot[slot];
+            visit(static_cast<unsigned int>(slot));
+            slot = next;
+        }
+    }
+
+private:
+    int tileIndex(sf::Vector2i tile) const;
+
+    sf::Vector2u size;
+
+    std::vector<int> tileHeads;
+    std::vector<int> nextSlot;
+    std::vector<int> previousSlot;
+    std::vector<int> slotTile;  // NONE while not placed
+};
+
+#endif
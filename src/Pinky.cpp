@@ -1,5 +0,0 @@
-#include "Pinky.h"
-
-void Pinky::setTargetTile(Entity& pacman) {
-
-};
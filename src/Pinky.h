@@ -2,10 +2,21 @@
 #define PINKY_H
 
 #include "Ghost.h"
+#include "MazeMap.h"
+#include <SFML/System/Vector2.hpp>
 
-class Pinky : public Ghost {
-public:
-    void setTargetTile(Entity& pacman);
+// Pink: ambushes 4 tiles ahead of Pac-Man and scatters to the top-left corner
+struct Pinky {
+    static constexpr Ghost::AIType type = Ghost::AIType::PINKY;
+    static constexpr bool followsPacmanField = false;
+
+    static sf::Vector2i chaseTarget(const MazeMap& map, sf::Vector2i pacmanTile, MovementDir pacmanDir) {
+        return Ghost::tileAhead(map, pacmanTile, pacmanDir, 4);
+    }
+
+    static sf::Vector2i scatterTarget(const MazeMap&) {
+        return {0, 0};
+    }
 };
 
 #endif
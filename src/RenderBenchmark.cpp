@@ -0,0 +1,83 @@
+#include "RenderBenchmark.h"
+#include "FrameStats.h"
+#include "Game.h"
+#include <SFML/System/Clock.hpp>
+#include <iomanip>
+#include <iostream>
+
+void RenderBenchmark::run() {
+    const int originalScaleFactor = game.getScaleFactor();
+    const bool originalUseStaticLayerCache = game.getStaticLayerCache();
+    const float pelletFillLevels[] = {1.0f, 0.5f, 0.0f};
+
+    game.loadResources();
+
+    std::cout << "Render benchmark: " << frameCount << " frames per configuration\n";
+    std::cout << "scale  fill  cache    p50 ms    p90 ms    p99 ms    max ms  draws/frame\n";
+
+    for (int benchScaleFactor : Game::supportedScaleFactors) {
+        game.setScaleFactor(benchScaleFactor);
+        sf::RenderTexture target(game.getWindowResolution());
+
+        for (float fillLevel : pelletFillLevels) {
+            for (bool cached : {false, true}) {
+                game.setStaticLayerCache(cached);
+                benchmarkScene(target, fillLevel);
+            }
+        }
+    }
+
+    game.setScaleFactor(originalScaleFactor);
+    game.setStaticLayerCache(originalUseStaticLayerCache);
+}
+
+void RenderBenchmark::benchmarkScene(sf::RenderTexture& target, float fillLevel) {
+    const unsigned int warmupFrames = 30;
+
+    game.setupScene();
+
+    // Eat an evenly spread share of the pellets so the layer keeps fillLevel of them
+    const MazeMap& map = game.getMap();
+    int pelletIndex = 0;
+    for (unsigned int y = 0; y < map.getHeight(); ++y) {
+        for (unsigned int x = 0; x < map.getWidth(); ++x) {
+            sf::Vector2i tile(x, y);
+            if (!map.hasPellet(tile)) continue;
+
+            float eatenShare = 1.0f - fillLevel;
+            if (static_cast<int>((pelletIndex + 1) * eatenShare) != static_cast<int>(pelletIndex * eatenShare)) {
+                game.removePellet(tile);
+            }
+            pelletIndex++;
+        }
+    }
+
+    FrameStats frameTimes;
+    frameTimes.reserve(frameCount);
+    unsigned int drawCalls = 0;
+    sf::Clock frameClock;
+
+    for (unsigned int frame = 0; frame < warmupFrames + frameCount; ++frame) {
+        frameClock.restart();
+
+        target.clear();
+        drawCalls = game.presentScene(target);
+        target.display();
+
+        if (frame >= warmupFrames) {
+            frameTimes.addSample(frameClock.getElapsedTime());
+        }
+    }
+
+    auto ms = [](sf::Time time) { return time.asMicroseconds() / 1000.0; };
+    std::cout << std::fixed << std::setprecision(3)
+              << std::setw(5) << game.getScaleFactor() << "  "
+              << std::setw(3) << static_cast<int>(fillLevel * 100) << "%"
+              << std::setw(7) << (game.getStaticLayerCache() ? "on" : "off")
+              << std::setw(10) << ms(frameTimes.getPercentile(50))
+              << std::setw(10) << ms(frameTimes.getPercentile(90))
+              << std::setw(10) << ms(frameTimes.getPercentile(99))
+              << std::setw(10) << ms(frameTimes.getMax())
+              << std::setw(13) << drawCalls << '\n';
+    frameTimes.printHistogram(std::cout, 8);
+}
@@ -0,0 +1,25 @@
+#ifndef RENDERBENCHMARK_H
+#define RENDERBENCHMARK_H
+
+#include <SFML/Graphics/RenderTexture.hpp>
+
+class Game;
+
+// Draws and upscales the game's full scene offscreen for frameCount frames at
+// every supported scale factor and pellet fill level, with and without the
+// static layer cache, then prints frame-time percentiles
+class RenderBenchmark {
+public:
+    RenderBenchmark(Game& game, unsigned int frameCount) : game(game), frameCount(frameCount) {}
+
+    void run();
+
+private:
+    // One configuration at the game's current scale factor
+    void benchmarkScene(sf::RenderTexture& target, float fillLevel);
+
+    Game& game;
+    unsigned int frameCount;
+};
+
+#endif
@@ -0,0 +1,68 @@
+#include "Replay.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+void Replay::record(long long tick, const std::vector<InputEvent>& tickInput) {
+    for (const InputEvent& input : tickInput) {
+        entries.push_back({tick, input.direction, input.pressed});
+    }
+}
+
+void Replay::inputForTick(long long tick, std::vector<InputEvent>& out) const {
+    out.clear();
+
+    auto first = std::lower_bound(entries.begin(), entries.end(), tick,
+                                  [](const Entry& entry, long long value) { return entry.tick < value; });
+
+    for (auto it = first; it != entries.end() && it->tick == tick; ++it) {
+        out.push_back({it->direction, it->pressed, sf::Time::Zero});
+    }
+}
+
+bool Replay::saveToFile(const std::filesystem::path& replayPath) const {
+    std::ofstream file(replayPath);
+    if (!file.is_open()) return false;
+
+    for (const Entry& entry : entries) {
+        file << entry.tick << ' ' << static_cast<int>(entry.direction) << ' ' << entry.pressed << '\n';
+    }
+
+    return file.good();
+}
+
+bool Replay::loadFromFile(const std::filesystem::path& replayPath) {
+    std::ifstream file(replayPath);
+    if (!file.is_open()) return false;
+
+    // Parsed aside, so a file that fails part way leaves the current entries as they were
+    std::vector<Entry> loaded;
+    std::string line;
+
+    while (std::getline(file, line)) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+        // Exactly one "tick direction pressed" triple; a cut-off or garbled line fails the whole file
+        std::istringstream fields(line);
+        long long tick;
+        int direction;
+        bool pressed;
+        std::string rest;
+        if (!(fields >> tick >> direction >> pressed) || (fields >> rest) || tick < 0) {
+            return false;
+        }
+        if (direction < static_cast<int>(MovementDir::STATIC) || direction > static_cast<int>(MovementDir::RIGHT)) {
+            return false;
+        }
+        loaded.push_back({tick, static_cast<MovementDir>(direction), pressed});
+    }
+
+    if (file.bad()) return false;
+
+    std::stable_sort(loaded.begin(), loaded.end(),
+                     [](const Entry& a, const Entry& b) { return a.tick < b.tick; });
+
+    entries = std::move(loaded);
+    return true;
+}
@@ -0,0 +1,41 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <filesystem>
+#include <vector>
+
+#include "InputQueue.h"
+
+// Per-tick input log. Because tick() is deterministic, replaying the same
+// inputs from a fresh scene reproduces a game exactly.
+class Replay {
+public:
+    struct Entry {
+        long long tick;
+        MovementDir direction;
+        bool pressed;
+    };
+
+    void clear() { entries.clear(); }
+
+    // Ticks must be recorded in increasing order
+    void record(long long tick, const std::vector<InputEvent>& tickInput);
+
+    // Fills out with the inputs recorded for tick (timestamps are zero)
+    void inputForTick(long long tick, std::vector<InputEvent>& out) const;
+
+    long long getLastTick() const { return entries.empty() ? 0 : entries.back().tick; }
+
+    const std::vector<Entry>& getEntries() const { return entries; }
+
+    // Text format: one "tick direction pressed" triple per line
+    bool saveToFile(const std::filesystem::path& replayPath) const;
+
+    // False, keeping the current entries, if any line is not such a triple
+    bool loadFromFile(const std::filesystem::path& replayPath);
+
+private:
+    std::vector<Entry> entries;
+};
+
+#endif
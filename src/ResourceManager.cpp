@@ -2,24 +2,57 @@
 #include "MazeMap.h"
 #include <SFML/Audio/SoundBuffer.hpp>
 #include <SFML/Graphics/Font.hpp>
-#include <SFML/Graphics/RenderTexture.hpp>
-#include <SFML/Graphics/Sprite.hpp>
 #include <SFML/System/Vector2.hpp>
 #include <string>
 #include <fstream>
+#include <sstream>
 #include <vector>
 
+bool ResourceManager::openPack(const std::filesystem::path& packPath) {
+    if (pack.isOpen() && pack.getPath() == packPath) return true;
+    return pack.open(packPath);
+};
+
 bool ResourceManager::loadTexture(const std::string& textureName, const std::filesystem::path& texturePath) {
     auto texture = std::make_unique<sf::Texture>();
-    if (!texture->loadFromFile(texturePath)) return false;
+
+    // Uploaded straight from the mapped pixels
+    const AssetPack::Entry* entry = pack.find(texturePath);
+    if (entry && entry->type == AssetPack::Type::IMAGE) {
+        if (!texture->resize({entry->info[0], entry->info[1]})) return false;
+        texture->update(pack.getPayload(*entry));
+    } else if (!texture->loadFromFile(texturePath)) {
+        return false;
+    }
 
     textures[textureName] = std::move(texture);
     return true;
 };
 
+bool ResourceManager::loadImage(const std::string& imageName, const std::filesystem::path& imagePath) {
+    sf::Image image;
+
+    const AssetPack::Entry* entry = pack.find(imagePath);
+    if (entry && entry->type == AssetPack::Type::IMAGE) {
+        image.resize({entry->info[0], entry->info[1]}, pack.getPayload(*entry));
+    } else if (!image.loadFromFile(imagePath)) {
+        return false;
+    }
+
+    images[imageName] = std::move(image);
+    return true;
+};
+
 bool ResourceManager::loadFont(const std::string& fontName, const std::filesystem::path& fontPath) {
     sf::Font font;
-    if (!font.openFromFile(fontPath)) return false;
+
+    // The font keeps reading glyphs from the pack, which stays mapped while this manager lives
+    const AssetPack::Entry* entry = pack.find(fontPath);
+    if (entry && entry->type == AssetPack::Type::RAW) {
+        if (!font.openFromMemory(pack.getPayload(*entry), static_cast<std::size_t>(entry->size))) return false;
+    } else if (!font.openFromFile(fontPath)) {
+        return false;
+    }
 
     fonts[fontName] = font;
 
@@ -27,58 +60,89 @@ bool ResourceManager::loadFont(const std::string& fontName, const std::filesyste
 };
 
 bool ResourceManager::loadMap(const std::string& mapName, const std::filesystem::path& mapPath) {
-    std::ifstream file(mapPath);
-    if (!file.is_open()) return false;
-
     std::vector<int> mapData;
-    int value;
+    sf::Vector2u mapSize;
 
-    while (file >> value) {
-        mapData.push_back(value);
+    // Maps stay loose files, so they can be edited and hot-reloaded
+    if (!readMapFile(mapPath, mapData, mapSize)) {
+        return false;
     }
 
-    file.close();
+    setMap(mapName, mapData, mapSize);
 
-    if (mapName == "mazeMap") mazeMap = mapData;
-    if (mapName == "pelletMap") pelletMap = mapData;
-
-    return !mapData.empty();
+    return true;
 };
 
-bool ResourceManager::loadSound(const std::string& soundName, const std::filesystem::path& soundPath) {
-    sounds[soundName] = sf::SoundBuffer(soundPath);
+bool ResourceManager::readMapFile(const std::filesystem::path& mapPath, std::vector<int>& mapData, sf::Vector2u& mapSize) {
+    std::ifstream file(mapPath);
+    if (!file.is_open()) return false;
 
-    return true;
-};
+    // One maze row per line; every row must have the same width
+    mapData.clear();
+    mapSize = {0, 0};
+    std::string line;
 
+    while (std::getline(file, line)) {
+        std::istringstream row(line);
+        unsigned int rowWidth = 0;
+        int value;
 
-void ResourceManager::resizeTexture(const std::string& textureName, unsigned int newTextureTileSize) {
-    auto it = textures.find(textureName);
-    if (it == textures.end()) return;
+        while (row >> value) {
+            mapData.push_back(value);
+            rowWidth++;
+        }
 
-    sf::Texture& originalTexture = *it->second;
+        if (rowWidth == 0) continue;
+        if (mapSize.y > 0 && rowWidth != mapSize.x) return false;
 
-    originalTexture.setSmooth(false);
+        mapSize.x = rowWidth;
+        mapSize.y++;
+    }
+
+    file.close();
 
-    float scaleFactor = static_cast<float>(newTextureTileSize) / static_cast<float>(textureTileSize);
+    return !mapData.empty();
+};
 
-    sf::Vector2u originalSize = originalTexture.getSize();
-    sf::Vector2u newSize(
-        static_cast<unsigned int>(originalSize.x * scaleFactor),
-        static_cast<unsigned int>(originalSize.y * scaleFactor)
-    );
+void ResourceManager::setMap(const std::string& mapName, const std::vector<int>& mapData, sf::Vector2u mapSize) {
+    if (mapName == "mazeMap") mazeMap = mapData;
+    if (mapName == "pelletMap") pelletMap = mapData;
+    mapSizes[mapName] = mapSize;
+    mazeLayout.reset();
+};
 
-    sf::RenderTexture renderTexture(newSize);
+std::shared_ptr<const MazeLayout> ResourceManager::getMazeLayout() {
+    sf::Vector2u mazeSize = getMapSize("mazeMap");
+    if (!mazeLayout && mazeSize == getMapSize("pelletMap")) {
+        mazeLayout = MazeLayout::create(mazeMap, pelletMap, mazeSize);
+    }
 
-    renderTexture.clear(sf::Color::Transparent);
+    return mazeLayout;
+}
 
-    sf::Sprite sprite(originalTexture);
-    sprite.setScale({scaleFactor, scaleFactor});
-    renderTexture.draw(sprite);
-    renderTexture.display();
+bool ResourceManager::loadSound(const std::string& soundName, const std::filesystem::path& soundPath) {
+    // Pre-decoded PCM: no WAV parsing, just a copy into the buffer
+    const AssetPack::Entry* entry = pack.find(soundPath);
+    if (entry && entry->type == AssetPack::Type::SOUND) {
+        unsigned int channelCount = entry->info[0];
+        if (channelCount == 0 || channelCount > AssetPack::MAX_SOUND_CHANNELS || entry->size < AssetPack::MAX_SOUND_CHANNELS) return false;
+
+        const std::uint8_t* payload = pack.getPayload(*entry);
+        std::vector<sf::SoundChannel> channelMap;
+        for (unsigned int i = 0; i < channelCount; ++i) {
+            channelMap.push_back(static_cast<sf::SoundChannel>(payload[i]));
+        }
+
+        sf::SoundBuffer buffer;
+        const auto* samples = reinterpret_cast<const std::int16_t*>(payload + AssetPack::MAX_SOUND_CHANNELS);
+        std::uint64_t sampleCount = (entry->size - AssetPack::MAX_SOUND_CHANNELS) / sizeof(std::int16_t);
+        if (!buffer.loadFromSamples(samples, sampleCount, channelCount, entry->info[1], channelMap)) return false;
+
+        sounds[soundName] = std::move(buffer);
+        return true;
+    }
 
-    auto newTexture = std::make_unique<sf::Texture>(renderTexture.getTexture());
-    newTexture->setSmooth(false);
+    sounds[soundName] = sf::SoundBuffer(soundPath);
 
-    textures[textureName] = std::move(newTexture);
+    return true;
 };
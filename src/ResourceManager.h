@@ -3,6 +3,7 @@
 
 #include <SFML/Audio/SoundBuffer.hpp>
 #include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Image.hpp>
 #include <map>
 #include <string>
 #include <vector>
@@ -12,11 +13,18 @@
 #include <SFML/Graphics/Texture.hpp>
 //#include <SFML/Audio/SoundBuffer.hpp>
 
+#include "AssetPack.h"
 #include "MazeMap.h"
 
 class ResourceManager {
 public:
-    ResourceManager() : textureTileSize(8) {};
+    ResourceManager() {};
+
+    // Assets the pack holds are then read from it, already decoded; anything
+    // else still loads from its own file. False if the pack cannot be opened.
+    bool openPack(const std::filesystem::path& packPath);
+
+    bool hasPack() const { return pack.isOpen(); }
 
     bool loadTexture(const std::string& textureName, const std::filesystem::path& texturePath);
 
@@ -24,13 +32,28 @@ public:
 
     bool loadMap(const std::string& mapName, const std::filesystem::path& mapPath);
 
+    // Parses a map file without storing it; safe to call from any thread
+    static bool readMapFile(const std::filesystem::path& mapPath, std::vector<int>& mapData, sf::Vector2u& mapSize);
+
+    // Stores map data built in memory, e.g. by MazeGenerator, as if loaded from a file
+    void setMap(const std::string& mapName, const std::vector<int>& mapData, sf::Vector2u mapSize);
+
     bool loadSound(const std::string& soundName, const std::filesystem::path& soundPath);
 
+    // An empty texture if none was loaded under textureName, e.g. when the
+    // scene is drawn by a SoftwareRenderer and sprites only need their rects
     sf::Texture& getTexture(const std::string& textureName) {
-        return *textures[textureName];
+        std::unique_ptr<sf::Texture>& texture = textures[textureName];
+        if (!texture) texture = std::make_unique<sf::Texture>();
+        return *texture;
     };
 
-    void resizeTexture(const std::string& textureName, unsigned int newTextureTileSize);
+    // CPU-side images, which need no GPU or GL context
+    bool loadImage(const std::string& imageName, const std::filesystem::path& imagePath);
+
+    sf::Image& getImage(const std::string& imageName) {
+        return images[imageName];
+    };
 
     std::vector<int>& getMazeMap() {
         return mazeMap;
@@ -40,6 +63,16 @@ public:
         return pelletMap;
     }
 
+    // The loaded maze and pellet maps as one immutable layout, built on first use
+    // and shared by every MazeMap loaded from it; nullptr if their sizes disagree
+    std::shared_ptr<const MazeLayout> getMazeLayout();
+
+    // Width and height in tiles of a loaded map, or 0x0 if it isn't loaded
+    sf::Vector2u getMapSize(const std::string& mapName) const {
+        auto it = mapSizes.find(mapName);
+        return it != mapSizes.end() ? it->second : sf::Vector2u(0, 0);
+    }
+
     sf::SoundBuffer* getSound(const std::string& soundName) {
         return &sounds[soundName];
     };
@@ -51,9 +84,12 @@ public:
     //load gameplay info
 
 private:
+    // Declared first so it outlives the fonts and sounds reading from its pages
+    AssetPack pack;
+
     //textures and sprites
     std::map<std::string, std::unique_ptr<sf::Texture>> textures;
-    const int textureTileSize;
+    std::map<std::string, sf::Image> images;
 
     //fonts 
     std::map<std::string, sf::Font> fonts;
@@ -64,6 +100,8 @@ private:
     //map 
     std::vector<int> mazeMap;
     std::vector<int> pelletMap;
+    std::map<std::string, sf::Vector2u> mapSizes;
+    std::shared_ptr<const MazeLayout> mazeLayout;  // reset whenever either map changes
 
     //gameplay info (speeds, scores, etc.)
 };
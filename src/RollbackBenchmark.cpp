@@ -0,0 +1,102 @@
+#include "RollbackBenchmark.h"
+#include "FrameStats.h"
+#include "Game.h"
+#include <SFML/System/Clock.hpp>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+void RollbackBenchmark::run() {
+    if (rollbackTicks == 0) {
+        throw std::runtime_error("Rollback benchmark needs at least one tick to re-simulate");
+    }
+
+    game.loadResources();
+    game.setupScene();
+    game.setGhostPlayerControlled(true);
+
+    // Actors keep moving for the whole run: no intro pause and no game over
+    game.setStressMode(true);
+
+    // Scripted players: each turns at random every half second
+    std::mt19937 random(1);
+    std::uniform_int_distribution<int> pickDirection(0, 3);
+    const MovementDir directions[] = {MovementDir::UP, MovementDir::DOWN, MovementDir::LEFT, MovementDir::RIGHT};
+    MovementDir ghostDirection = MovementDir::LEFT;
+
+    std::vector<std::vector<InputEvent>> pacmanInputs(rollbackTicks);
+    std::vector<MovementDir> ghostInputs(rollbackTicks);
+    std::vector<Game::Snapshot> saved(rollbackTicks);
+
+    // Saves the state before every tick, as versus mode does
+    auto runScripted = [&]() {
+        for (unsigned int i = 0; i < rollbackTicks; ++i) {
+            game.saveSnapshot(saved[i]);
+            game.setGhostPlayerInput(ghostInputs[i]);
+            game.tick(pacmanInputs[i]);
+        }
+    };
+
+    auto sameState = [](const Game::Snapshot& a, const Game::Snapshot& b) {
+        if (a.tickCount != b.tickCount || a.score != b.score || a.eatenPellets != b.eatenPellets ||
+            a.pacman.getPosition() != b.pacman.getPosition() || a.ghosts.size() != b.ghosts.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < a.ghosts.size(); ++i) {
+            if (a.ghosts[i].getPosition() != b.ghosts[i].getPosition()) return false;
+        }
+        return true;
+    };
+
+    Game::Snapshot start;
+    Game::Snapshot expected;
+    Game::Snapshot actual;
+    FrameStats rollbackTimes;
+    rollbackTimes.reserve(iterations);
+    std::size_t mismatches = 0;
+
+    for (unsigned int iteration = 0; iteration < iterations; ++iteration) {
+        for (unsigned int i = 0; i < rollbackTicks; ++i) {
+            long long tickNumber = game.getTickCount() + 1 + i;
+            pacmanInputs[i].clear();
+            if (tickNumber % 30 == 0) {
+                pacmanInputs[i].push_back({directions[pickDirection(random)], true, sf::Time::Zero});
+            }
+            if (tickNumber % 30 == 15) {
+                ghostDirection = directions[pickDirection(random)];
+            }
+            ghostInputs[i] = ghostDirection;
+        }
+
+        game.saveSnapshot(start);
+        runScripted();
+        game.saveSnapshot(expected);
+
+        sf::Clock clock;
+        game.loadSnapshot(start);
+        game.setResimulating(true);
+        runScripted();
+        game.setResimulating(false);
+        rollbackTimes.addSample(clock.getElapsedTime());
+
+        game.saveSnapshot(actual);
+        if (!sameState(expected, actual)) {
+            mismatches++;
+        }
+    }
+
+    game.setStressMode(false);
+
+    const double frameBudgetMs = 1000.0 / game.getFramerate();
+    const double p99Ms = rollbackTimes.getPercentile(99).asMicroseconds() / 1000.0;
+    std::cout << std::fixed << std::setprecision(3)
+              << "Rollback: restore + " << rollbackTicks << " ticks, " << iterations << " runs: mean "
+              << rollbackTimes.getMean().asMicroseconds() / 1000.0 << " ms, p99 " << p99Ms << " ms, max "
+              << rollbackTimes.getMax().asMicroseconds() / 1000.0 << " ms\n"
+              << "Frame budget " << frameBudgetMs << " ms: p99 uses " << std::setprecision(1)
+              << 100.0 * p99Ms / frameBudgetMs << "%\n"
+              << "Re-simulations that diverged: " << mismatches << std::endl;
+    rollbackTimes.printHistogram(std::cout, 8);
+}
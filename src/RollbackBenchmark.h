@@ -0,0 +1,21 @@
+#ifndef ROLLBACKBENCHMARK_H
+#define ROLLBACKBENCHMARK_H
+
+class Game;
+
+// Times restoring a game snapshot and re-simulating rollbackTicks ticks against
+// the frame budget, and checks each re-simulation ends in the same state
+class RollbackBenchmark {
+public:
+    RollbackBenchmark(Game& game, unsigned int rollbackTicks, unsigned int iterations)
+        : game(game), rollbackTicks(rollbackTicks), iterations(iterations) {}
+
+    void run();
+
+private:
+    Game& game;
+    unsigned int rollbackTicks;
+    unsigned int iterations;
+};
+
+#endif
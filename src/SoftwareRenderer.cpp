@@ -0,0 +1,178 @@
+#include "SoftwareRenderer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// x / 255 rounded to nearest, exact for every x a blend can produce
+inline unsigned int divide255(unsigned int x) {
+    return (x + 127) / 255;
+}
+
+// SFML's BlendAlpha: colour by source alpha, alpha channel by one
+inline void blendPixel(std::uint8_t* destination, const std::uint8_t* source) {
+    unsigned int alpha = source[3];
+    if (alpha == 255) {
+        std::memcpy(destination, source, 4);
+    } else if (alpha != 0) {
+        for (int channel = 0; channel < 3; ++channel) {
+            destination[channel] = static_cast<std::uint8_t>(divide255(source[channel] * alpha + destination[channel] * (255 - alpha)));
+        }
+        destination[3] = static_cast<std::uint8_t>(divide255(255 * alpha + destination[3] * (255 - alpha)));
+    }
+}
+
+#if defined(__SSE2__)
+// blendPixel() for the two pixels widened to 16-bit lanes in source and destination
+inline __m128i blendTwoPixels(__m128i source, __m128i destination) {
+    const __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    const __m128i max = _mm_set1_epi16(255);
+
+    // Each pixel's alpha in all four of its lanes
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(source, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m128i sourceFactor = _mm_or_si128(_mm_andnot_si128(alphaLanes, alpha), _mm_and_si128(alphaLanes, max));
+
+    // At most 255 * 255 + 127, so the sums fit unsigned 16-bit lanes
+    __m128i sum = _mm_add_epi16(_mm_mullo_epi16(source, sourceFactor), _mm_mullo_epi16(destination, _mm_sub_epi16(max, alpha)));
+    sum = _mm_add_epi16(sum, _mm_set1_epi16(127));
+
+    // floor(x / 255) == (x * 0x8081) >> 23 for every 16-bit x
+    return _mm_srli_epi16(_mm_mulhi_epu16(sum, _mm_set1_epi16(static_cast<short>(0x8081))), 7);
+}
+#endif
+
+// Blends count source pixels over destination. Four at a time with SSE2:
+// all-opaque groups are copied and all-transparent ones skipped, which is
+// nearly every group in the atlas
+void blendRow(std::uint8_t* destination, const std::uint8_t* source, int count) {
+    int i = 0;
+
+#if defined(__SSE2__)
+    const __m128i alphaBytes = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i sourcePixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+        __m128i sourceAlpha = _mm_and_si128(sourcePixels, alphaBytes);
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(sourceAlpha, alphaBytes)) == 0xFFFF) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 4), sourcePixels);
+            continue;
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(sourceAlpha, zero)) == 0xFFFF) continue;
+
+        __m128i destinationPixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(destination + i * 4));
+        __m128i low = blendTwoPixels(_mm_unpacklo_epi8(sourcePixels, zero), _mm_unpacklo_epi8(destinationPixels, zero));
+        __m128i high = blendTwoPixels(_mm_unpackhi_epi8(sourcePixels, zero), _mm_unpackhi_epi8(destinationPixels, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 4), _mm_packus_epi16(low, high));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        blendPixel(destination + i * 4, source + i * 4);
+    }
+}
+
+}
+
+SoftwareRenderer::SoftwareRenderer(sf::Vector2u size)
+    : size(size), pixels(static_cast<std::size_t>(size.x) * size.y * 4) {
+    resetView();
+}
+
+void SoftwareRenderer::setView(sf::Vector2f newViewTopLeft, sf::IntRect clipRect) {
+    viewTopLeft = newViewTopLeft;
+
+    // Keep the clip rect inside the framebuffer
+    sf::Vector2i first(std::max(clipRect.position.x, 0), std::max(clipRect.position.y, 0));
+    sf::Vector2i end(std::min(clipRect.position.x + clipRect.size.x, static_cast<int>(size.x)),
+                     std::min(clipRect.position.y + clipRect.size.y, static_cast<int>(size.y)));
+    clip = sf::IntRect(first, {std::max(end.x - first.x, 0), std::max(end.y - first.y, 0)});
+}
+
+void SoftwareRenderer::resetView() {
+    setView({0.0f, 0.0f}, sf::IntRect({0, 0}, sf::Vector2i(size)));
+}
+
+void SoftwareRenderer::clear(sf::Color color) {
+    if (pixels.empty()) return;
+
+    // One row by pixel, the rest copied from it
+    const std::uint8_t pixel[4] = {color.r, color.g, color.b, color.a};
+    const std::size_t rowBytes = static_cast<std::size_t>(size.x) * 4;
+    for (std::size_t offset = 0; offset < rowBytes; offset += 4) {
+        std::memcpy(&pixels[offset], pixel, 4);
+    }
+    for (std::size_t offset = rowBytes; offset < pixels.size(); offset += rowBytes) {
+        std::memcpy(&pixels[offset], pixels.data(), rowBytes);
+    }
+}
+
+bool SoftwareRenderer::clipQuad(sf::Vector2f position, sf::Vector2f extent, sf::Vector2i& first, sf::Vector2i& end) const {
+    // A pixel is covered when its centre is inside the quad, left and top edges included
+    sf::Vector2f pixelPosition = sf::Vector2f(clip.position) + position - viewTopLeft;
+    first = {static_cast<int>(std::ceil(pixelPosition.x - 0.5f)), static_cast<int>(std::ceil(pixelPosition.y - 0.5f))};
+    end = {static_cast<int>(std::ceil(pixelPosition.x + extent.x - 0.5f)), static_cast<int>(std::ceil(pixelPosition.y + extent.y - 0.5f))};
+
+    return first.x < clip.position.x + clip.size.x && first.y < clip.position.y + clip.size.y &&
+           end.x > clip.position.x && end.y > clip.position.y && first.x < end.x && first.y < end.y;
+}
+
+void SoftwareRenderer::fill(sf::FloatRect rect, sf::Color color) {
+    sf::Vector2i first, end;
+    if (!clipQuad(rect.position, rect.size, first, end)) return;
+
+    int left = std::max(first.x, clip.position.x);
+    int right = std::min(end.x, clip.position.x + clip.size.x);
+    int top = std::max(first.y, clip.position.y);
+    int bottom = std::min(end.y, clip.position.y + clip.size.y);
+
+    const std::uint8_t pixel[4] = {color.r, color.g, color.b, color.a};
+    for (int y = top; y < bottom; ++y) {
+        std::uint8_t* row = &pixels[(static_cast<std::size_t>(y) * size.x + left) * 4];
+        for (int x = left; x < right; ++x, row += 4) {
+            blendPixel(row, pixel);
+        }
+    }
+}
+
+void SoftwareRenderer::blit(sf::IntRect sourceRect, sf::Vector2f position) {
+    if (atlas) blit(*atlas, sourceRect, position);
+}
+
+void SoftwareRenderer::blit(const sf::Image& source, sf::IntRect sourceRect, sf::Vector2f position) {
+    sf::Vector2i first, end;
+    if (!clipQuad(position, sf::Vector2f(sourceRect.size), first, end)) return;
+
+    int left = std::max(first.x, clip.position.x);
+    int right = std::min(end.x, clip.position.x + clip.size.x);
+    int top = std::max(first.y, clip.position.y);
+    int bottom = std::min(end.y, clip.position.y + clip.size.y);
+
+    // Texels outside the source are never read
+    sf::Vector2u atlasSize = source.getSize();
+    int sourceLeft = sourceRect.position.x + (left - first.x);
+    int sourceTop = sourceRect.position.y + (top - first.y);
+    if (sourceLeft < 0 || sourceTop < 0) return;
+    right = std::min(right, left + static_cast<int>(atlasSize.x) - sourceLeft);
+    bottom = std::min(bottom, top + static_cast<int>(atlasSize.y) - sourceTop);
+    if (right <= left || bottom <= top) return;
+
+    const std::uint8_t* atlasPixels = source.getPixelsPtr();
+    for (int y = top; y < bottom; ++y) {
+        const std::uint8_t* source = atlasPixels + (static_cast<std::size_t>(sourceTop + y - top) * atlasSize.x + sourceLeft) * 4;
+        std::uint8_t* destination = &pixels[(static_cast<std::size_t>(y) * size.x + left) * 4];
+        blendRow(destination, source, right - left);
+    }
+}
+
+sf::Image SoftwareRenderer::toImage() const {
+    sf::Image image;
+    image.resize(size, pixels.data());
+    return image;
+}
@@ -0,0 +1,65 @@
+#ifndef SOFTWARERENDERER_H
+#define SOFTWARERENDERER_H
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <vector>
+
+// Draws the scene into an RGBA8 framebuffer on the CPU, with no GPU or GL
+// context. Every draw is an axis-aligned quad of atlas pixels or a flat colour,
+// rasterised like SFML does them: nearest sampling, pixel centres inside the
+// quad, and BlendAlpha rounded to the nearest 8-bit value.
+class SoftwareRenderer {
+public:
+    explicit SoftwareRenderer(sf::Vector2u size);
+
+    sf::Vector2u getSize() const { return size; }
+
+    // Source of every blit(); the image must outlive the draws that use it
+    void setAtlas(const sf::Image& atlasImage) { atlas = &atlasImage; }
+
+    // Like an unrotated, unscaled sf::View with a viewport: the world point
+    // viewTopLeft lands on the clip rect's top-left pixel and nothing is
+    // drawn outside the clip rect
+    void setView(sf::Vector2f viewTopLeft, sf::IntRect clipRect);
+
+    // Back to world = pixel coordinates over the whole framebuffer
+    void resetView();
+
+    sf::Vector2f getViewTopLeft() const { return viewTopLeft; }
+    sf::Vector2u getViewSize() const { return sf::Vector2u(clip.size); }
+
+    void clear(sf::Color color = sf::Color::Black);
+
+    // An untextured quad, as MazeMap draws flat walls
+    void fill(sf::FloatRect rect, sf::Color color);
+
+    // Atlas pixels sourceRect with their top-left corner at position
+    void blit(sf::IntRect sourceRect, sf::Vector2f position);
+
+    // The same from another image, e.g. a DigitAtlas strip
+    void blit(const sf::Image& source, sf::IntRect sourceRect, sf::Vector2f position);
+
+    // Rows of RGBA8 pixels, top row first, like sf::Image::getPixelsPtr()
+    const std::uint8_t* getPixels() const { return pixels.data(); }
+
+    sf::Image toImage() const;
+
+private:
+    // Pixels [first, end) covered by a quad at position of the given world
+    // extent; false if none of them are inside the clip rect
+    bool clipQuad(sf::Vector2f position, sf::Vector2f extent, sf::Vector2i& first, sf::Vector2i& end) const;
+
+    sf::Vector2u size;
+    std::vector<std::uint8_t> pixels;
+
+    const sf::Image* atlas = nullptr;
+
+    sf::Vector2f viewTopLeft;
+    sf::IntRect clip;
+};
+
+#endif
@@ -0,0 +1,74 @@
+#include "StressTest.h"
+#include "FrameStats.h"
+#include "Game.h"
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <SFML/System/Clock.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+void StressTest::run() {
+    if (settings.aiTypes.empty()) {
+        throw std::runtime_error("Stress test needs at least one ghost AI type");
+    }
+
+    game.loadResources();
+    game.setStressMode(true);
+
+    sf::RenderTexture target(game.getBaseResolution());
+    const std::vector<InputEvent> noInput;
+
+    std::cout << "Stress test: " << settings.tickCount << " ticks and " << settings.frameCount << " frames per ghost count\n";
+
+    // The Pac-Man distance field is rebuilt in full whenever he enters a new
+    // tile; this is what that costs, next to how often it can happen
+    game.setupScene();
+    MazeMap map = game.getMap();  // a copy, so the game keeps its own field
+    const sf::Vector2i fieldSources[2] = {map.getTileCoords(game.getPacman().getPosition()), map.findNearestOpenTile({1, 1})};
+    const unsigned int fieldRebuilds = 1000;
+    sf::Clock fieldClock;
+    for (unsigned int i = 0; i < fieldRebuilds; ++i) {
+        map.updatePacmanDistanceField(fieldSources[i % 2]);
+    }
+    const double rebuildMicroseconds = fieldClock.getElapsedTime().asMicroseconds() / static_cast<double>(fieldRebuilds);
+    const float ticksPerTile = game.getBaseTileSize() / game.getTuning().perPixelMove;
+    std::cout << std::fixed << std::setprecision(2) << "Pac-Man distance field: " << rebuildMicroseconds
+              << " us per full BFS, at most once every " << ticksPerTile << " ticks ("
+              << rebuildMicroseconds / ticksPerTile << " us/tick amortised)\n";
+
+    std::cout << "   ghosts     ticks/s   ms/tick   draw ms/frame\n";
+
+    for (std::size_t ghostCount : settings.ghostCounts) {
+        game.setupScene();
+        game.spawnGhosts(ghostCount, settings.aiTypes);
+
+        sf::Clock clock;
+        for (unsigned int i = 0; i < settings.tickCount; ++i) {
+            game.tick(noInput);
+        }
+        double tickSeconds = clock.getElapsedTime().asMicroseconds() / 1e6;
+
+        FrameStats drawTimes;
+        drawTimes.reserve(settings.frameCount);
+        for (unsigned int frame = 0; frame < settings.frameCount; ++frame) {
+            clock.restart();
+            target.clear();
+            game.drawScene(target);
+            target.display();
+            drawTimes.addSample(clock.getElapsedTime());
+        }
+
+        std::cout << std::fixed
+                  << std::setw(9) << ghostCount
+                  << std::setw(12) << std::setprecision(1) << settings.tickCount / std::max(tickSeconds, 1e-9)
+                  << std::setw(10) << std::setprecision(3) << tickSeconds * 1000.0 / std::max(1u, settings.tickCount);
+        if (settings.frameCount > 0) {
+            std::cout << std::setw(16) << drawTimes.getMean().asMicroseconds() / 1000.0;
+        }
+        std::cout << '\n' << std::flush;
+    }
+
+    game.setStressMode(false);
+}
+
@@ -0,0 +1,32 @@
+#ifndef STRESSTEST_H
+#define STRESSTEST_H
+
+#include <cstddef>
+#include <vector>
+
+#include "Ghost.h"
+
+class Game;
+
+// Spreads ever more ghosts over a game's maze and reports simulation ticks per
+// second and draw time as the count grows
+class StressTest {
+public:
+    struct Settings {
+        std::vector<std::size_t> ghostCounts = {4, 16, 64, 256, 1024, 4096, 16384, 65536, 100000};
+        std::vector<Ghost::AIType> aiTypes = {Ghost::AIType::BLINKY, Ghost::AIType::PINKY,
+                                              Ghost::AIType::INKY, Ghost::AIType::CLYDE};  // cycled
+        unsigned int tickCount = 300;   // simulated ticks per ghost count
+        unsigned int frameCount = 10;   // offscreen frames per ghost count, 0 to skip drawing
+    };
+
+    StressTest(Game& game, const Settings& settings) : game(game), settings(settings) {}
+
+    void run();
+
+private:
+    Game& game;
+    Settings settings;
+};
+
+#endif
@@ -0,0 +1,38 @@
+#include "SweptContact.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+// Narrows [entry, exit] to the times at which |offset + t * velocity| < contactDistance
+bool clipAxis(float offset, float velocity, float contactDistance, float& entry, float& exit) {
+    if (velocity == 0.0f) {
+        return std::abs(offset) < contactDistance;
+    }
+
+    float enter = (-contactDistance - offset) / velocity;
+    float leave = (contactDistance - offset) / velocity;
+    if (enter > leave) std::swap(enter, leave);
+
+    entry = std::max(entry, enter);
+    exit = std::min(exit, leave);
+    return entry < exit;
+}
+
+} // namespace
+
+std::optional<float> sweptContactTime(sf::Vector2f aStart, sf::Vector2f aEnd,
+                                      sf::Vector2f bStart, sf::Vector2f bEnd,
+                                      float contactDistance) {
+    // Work in b's frame: a single moving point against a fixed box
+    sf::Vector2f offset = aStart - bStart;
+    sf::Vector2f velocity = (aEnd - aStart) - (bEnd - bStart);
+
+    float entry = 0.0f;
+    float exit = 1.0f;
+    if (!clipAxis(offset.x, velocity.x, contactDistance, entry, exit)) return std::nullopt;
+    if (!clipAxis(offset.y, velocity.y, contactDistance, entry, exit)) return std::nullopt;
+
+    return entry;
+}
@@ -0,0 +1,15 @@
+#ifndef SWEPTCONTACT_H
+#define SWEPTCONTACT_H
+
+#include <SFML/System/Vector2.hpp>
+#include <optional>
+
+// Earliest fraction of a tick, in [0, 1], at which two centres moving in straight
+// lines (aStart to aEnd and bStart to bEnd) come within contactDistance of each
+// other on both axes. Exact for any step length, so entities cannot pass through
+// each other between two ticks. Empty if they never do.
+std::optional<float> sweptContactTime(sf::Vector2f aStart, sf::Vector2f aEnd,
+                                      sf::Vector2f bStart, sf::Vector2f bEnd,
+                                      float contactDistance);
+
+#endif
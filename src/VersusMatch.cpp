@@ -0,0 +1,186 @@
+#include "VersusMatch.h"
+#include "FrameStats.h"
+#include "Game.h"
+#include "InputQueue.h"
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/System/Clock.hpp>
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+void VersusMatch::run() {
+    if (settings.maxRollbackTicks == 0) {
+        throw std::runtime_error("Versus mode needs a rollback window of at least one tick");
+    }
+
+    game.loadResources();
+    game.setupScene();
+    game.setGhostPlayerControlled(true);
+
+    auto window = sf::RenderWindow(sf::VideoMode(game.getWindowResolution()), game.getWindowName() + " - versus");
+    window.setKeyRepeatEnabled(false);  // auto-repeat would send fake presses to the other peer
+    window.setVerticalSyncEnabled(game.getPacingMode() == Game::PacingMode::VSYNC);
+    bool windowFocused = window.hasFocus();
+
+    sf::Clock clock;
+    sf::Clock runClock;
+    InputQueue pacmanInput(InputQueue::KeySet::ARROWS);
+    InputQueue ghostInput(InputQueue::KeySet::WASD);
+    std::vector<InputEvent> ghostEvents;
+    std::vector<MovementDir> ghostHeldDirections;  // the ghost player's keys, most recent press last
+
+    const sf::Time FIXED_TIMESTEP = sf::seconds(1.0f / game.getFramerate());
+    sf::Time accumulator = sf::Time::Zero;
+    const int maxCatchUpTicks = 5;
+
+    // The state before each of the last maxRollbackTicks + 1 ticks and the inputs it ran with
+    struct TickRecord {
+        Game::Snapshot before;
+        std::vector<InputEvent> pacmanInput;
+        MovementDir ghostInput = MovementDir::STATIC;
+    };
+    std::vector<TickRecord> history(settings.maxRollbackTicks + 1);
+    auto recordFor = [&](long long tickNumber) -> TickRecord& { return history[tickNumber % history.size()]; };
+
+    std::unordered_map<long long, MovementDir> remoteInputs;  // confirmed, by tick
+    long long confirmedThrough = game.getTickCount();  // every tick up to here has its remote input
+    long long latestRemoteTick = game.getTickCount();
+    MovementDir latestRemoteInput = MovementDir::STATIC;
+    long long lastSentTick = game.getTickCount();
+    std::vector<InputPacket> packets;
+
+    // Runs the tick with its recorded local input and the best remote input known:
+    // the confirmed one, or else a prediction that the keys have not changed
+    auto simulate = [&](long long tickNumber) {
+        TickRecord& record = recordFor(tickNumber);
+        game.saveSnapshot(record.before);
+
+        auto confirmed = remoteInputs.find(tickNumber);
+        record.ghostInput = confirmed != remoteInputs.end() ? confirmed->second : latestRemoteInput;
+        game.setGhostPlayerInput(record.ghostInput);
+        game.tick(record.pacmanInput);
+    };
+
+    FrameStats rollbackTimes;
+    std::size_t resimulatedTicks = 0;
+    std::size_t stalledTicks = 0;
+
+    while (window.isOpen())
+    {
+        while (const std::optional event = window.pollEvent())
+        {
+            if (event->is<sf::Event::Closed>())
+            {
+                window.close();
+            }
+            else if (event->is<sf::Event::FocusLost>())
+            {
+                windowFocused = false;
+            }
+            else if (event->is<sf::Event::FocusGained>())
+            {
+                windowFocused = true;
+            }
+            else if (!pacmanInput.pushEvent(*event, runClock.getElapsedTime()))
+            {
+                ghostInput.pushEvent(*event, runClock.getElapsedTime());
+            }
+        }
+
+        sf::Time elapsedTime = clock.restart();
+        accumulator += elapsedTime;
+        sf::Time frameStart = runClock.getElapsedTime();
+
+        sf::Time tickDeadline = frameStart - accumulator;
+        int catchUpTicks = 0;
+        while (accumulator >= FIXED_TIMESTEP && catchUpTicks < maxCatchUpTicks) {
+            accumulator -= FIXED_TIMESTEP;
+            tickDeadline += FIXED_TIMESTEP;
+            catchUpTicks++;
+            long long nextTick = game.getTickCount() + 1;
+
+            // Stand-in for the remote peer: send its held direction for the tick it is on
+            if (nextTick > lastSentTick) {
+                ghostInput.popUntil(tickDeadline, ghostEvents);
+                for (const InputEvent& input : ghostEvents) {
+                    ghostHeldDirections.erase(std::remove(ghostHeldDirections.begin(), ghostHeldDirections.end(), input.direction),
+                                              ghostHeldDirections.end());
+                    if (input.pressed) ghostHeldDirections.push_back(input.direction);
+                }
+                transport.send({nextTick, ghostHeldDirections.empty() ? MovementDir::STATIC : ghostHeldDirections.back()});
+                lastSentTick = nextTick;
+            }
+
+            // Confirmed remote input; a wrong prediction rolls back to its tick
+            transport.receive(packets);
+            long long rollbackFrom = nextTick;
+            for (const InputPacket& packet : packets) {
+                if (packet.tick <= confirmedThrough) continue;
+
+                remoteInputs[packet.tick] = packet.direction;
+                if (packet.tick > latestRemoteTick) {
+                    latestRemoteTick = packet.tick;
+                    latestRemoteInput = packet.direction;
+                }
+                if (packet.tick <= game.getTickCount() && recordFor(packet.tick).ghostInput != packet.direction) {
+                    rollbackFrom = std::min(rollbackFrom, packet.tick);
+                }
+            }
+            while (remoteInputs.count(confirmedThrough + 1)) {
+                confirmedThrough++;
+            }
+            for (auto it = remoteInputs.begin(); it != remoteInputs.end();) {
+                it = it->first + static_cast<long long>(history.size()) < confirmedThrough ? remoteInputs.erase(it) : std::next(it);
+            }
+
+            if (rollbackFrom <= game.getTickCount()) {
+                sf::Clock rollbackClock;
+                long long latestTick = game.getTickCount();
+
+                game.loadSnapshot(recordFor(rollbackFrom).before);
+                game.setResimulating(true);
+                for (long long tickNumber = rollbackFrom; tickNumber <= latestTick; ++tickNumber) {
+                    simulate(tickNumber);
+                }
+                game.setResimulating(false);
+
+                rollbackTimes.addSample(rollbackClock.getElapsedTime());
+                resimulatedTicks += latestTick - rollbackFrom + 1;
+            }
+
+            // Any further ahead and a late input could need more rollback than the
+            // history holds, so wait for the remote input instead
+            if (nextTick - confirmedThrough > static_cast<long long>(settings.maxRollbackTicks)) {
+                stalledTicks++;
+                continue;
+            }
+
+            pacmanInput.popUntil(tickDeadline, recordFor(nextTick).pacmanInput);
+            simulate(nextTick);
+        }
+
+        if (accumulator >= FIXED_TIMESTEP) {
+            accumulator = accumulator % FIXED_TIMESTEP;
+        }
+
+        game.setInterpolationAlpha(accumulator / FIXED_TIMESTEP);
+
+        window.clear();
+        game.presentScene(window);
+        window.display();
+
+        game.paceFrame(clock, FIXED_TIMESTEP - accumulator, windowFocused);
+    }
+
+    std::cout << "Versus: " << rollbackTimes.getSampleCount() << " rollbacks re-simulated " << resimulatedTicks
+              << " ticks, " << stalledTicks << " ticks waited for input" << std::endl;
+    if (rollbackTimes.getSampleCount() > 0) {
+        std::cout << "Rollback time: mean " << rollbackTimes.getMean().asMicroseconds() / 1000.0 << " ms, p99 "
+                  << rollbackTimes.getPercentile(99).asMicroseconds() / 1000.0 << " ms, max "
+                  << rollbackTimes.getMax().asMicroseconds() / 1000.0 << " ms of a "
+                  << 1000.0 / game.getFramerate() << " ms frame" << std::endl;
+    }
+}
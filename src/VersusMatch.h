@@ -0,0 +1,29 @@
+#ifndef VERSUSMATCH_H
+#define VERSUSMATCH_H
+
+#include "NetTransport.h"
+
+class Game;
+
+// Local versus on a game: Pac-Man on the arrow keys, Blinky on WASD. The ghost
+// player's input goes through transport as if from a remote peer; the match
+// predicts it and, when a prediction was wrong, rolls the game back and
+// re-simulates within the frame
+class VersusMatch {
+public:
+    struct Settings {
+        unsigned int maxRollbackTicks = 8;  // the game waits for remote input rather than predict further
+    };
+
+    VersusMatch(Game& game, NetTransport& transport, const Settings& settings)
+        : game(game), transport(transport), settings(settings) {}
+
+    void run();
+
+private:
+    Game& game;
+    NetTransport& transport;
+    Settings settings;
+};
+
+#endif
@@ -1,11 +1,261 @@
+#include "FrameCapture.h"
+#include "Fuzzer.h"
 #include "Game.h"
+#include "LoopbackTransport.h"
+#include "MazeGenerator.h"
+#include "ObservationBenchmark.h"
+#include "RenderBenchmark.h"
+#include "RollbackBenchmark.h"
+#include "StressTest.h"
+#include "VersusMatch.h"
+#include <SFML/System/Clock.hpp>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <exception>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static Game::PacingMode parsePacingMode(const std::string& name) {
+    if (name == "unlimited") return Game::PacingMode::UNLIMITED;
+    if (name == "vsync") return Game::PacingMode::VSYNC;
+    if (name == "hybrid") return Game::PacingMode::HYBRID;
+    if (name == "lowpower") return Game::PacingMode::LOW_POWER;
+
+    throw std::runtime_error("Unknown pacing mode: " + name);
+}
+
+static MetricsExporter::Format parseMetricsFormat(const std::string& name) {
+    if (name == "prometheus") return MetricsExporter::Format::PROMETHEUS;
+    if (name == "jsonl") return MetricsExporter::Format::JSON_LINES;
+
+    throw std::runtime_error("Unknown metrics format: " + name);
+}
+
+static bool isNumber(const std::string& text) {
+    return !text.empty() && text.find_first_not_of("0123456789") == std::string::npos;
+}
+
+static ObservationEncoder::Format parseObservationFormat(const std::string& name) {
+    if (name == "gray") return ObservationEncoder::Format::GRAYSCALE;
+    if (name == "rgb332") return ObservationEncoder::Format::RGB332;
+    throw std::runtime_error("Unknown observation format: " + name);
+}
+
+static std::vector<Ghost::AIType> parseGhostTypes(const std::string& names) {
+    std::vector<Ghost::AIType> types;
+    std::size_t start = 0;
+
+    while (start <= names.size()) {
+        std::size_t end = names.find(',', start);
+        std::string name = names.substr(start, end == std::string::npos ? std::string::npos : end - start);
+
+        if (name == "blinky") types.push_back(Ghost::AIType::BLINKY);
+        else if (name == "pinky") types.push_back(Ghost::AIType::PINKY);
+        else if (name == "inky") types.push_back(Ghost::AIType::INKY);
+        else if (name == "clyde") types.push_back(Ghost::AIType::CLYDE);
+        else throw std::runtime_error("Unknown ghost: " + name);
+
+        if (end == std::string::npos) break;
+        start = end + 1;
+    }
+
+    return types;
+}
+
+static sf::Vector2u parseSize(const std::string& text) {
+    std::size_t separator = text.find('x');
+    if (separator == std::string::npos || !isNumber(text.substr(0, separator)) || !isNumber(text.substr(separator + 1))) {
+        throw std::runtime_error("Size must look like 28x31: " + text);
+    }
+
+    return {static_cast<unsigned int>(std::stoul(text.substr(0, separator))),
+            static_cast<unsigned int>(std::stoul(text.substr(separator + 1)))};
+}
+
+// Writes count generated mazes as maze_<seed>.txt/pellets_<seed>.txt pairs
+static void generateMazes(const MazeGenerator::Settings& settings, std::uint64_t firstSeed, std::size_t count,
+                          const std::filesystem::path& outputDir, unsigned int threadCount) {
+    std::filesystem::create_directories(outputDir);
+
+    MazeGenerator generator(settings);
+    std::atomic<std::size_t> failedWrites{0};
+    sf::Clock clock;
+
+    generator.generateBatch(firstSeed, count, threadCount, [&](const GeneratedMaze& maze) {
+        std::string seed = std::to_string(maze.seed);
+        if (!MazeGenerator::saveToFiles(maze, outputDir / ("maze_" + seed + ".txt"), outputDir / ("pellets_" + seed + ".txt"))) {
+            failedWrites++;
+        }
+    });
+
+    float seconds = clock.getElapsedTime().asSeconds();
+    std::cout << "Generated " << count << " " << settings.size.x << "x" << settings.size.y << " mazes in "
+              << seconds << " s (" << count / seconds << " mazes/s)\n";
+
+    if (failedWrites > 0) {
+        throw std::runtime_error(std::to_string(failedWrites.load()) + " mazes could not be written");
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args(argv + 1, argv + argc);
 
-int main() {
     try {
         Game game("assets/game/config.json");
-        game.run();
+
+        std::optional<unsigned int> renderBenchFrames;
+        std::optional<FrameCapture::Settings> capture;
+        std::optional<StressTest::Settings> stress;
+        std::optional<VersusMatch::Settings> versus;
+        std::optional<GameMetrics::ExportSettings> metrics;
+        std::optional<Fuzzer::Settings> fuzz;
+        std::optional<ObservationBenchmark::Settings> observe;
+        unsigned int netLatencyMs = 60;
+        unsigned int netJitterMs = 20;
+        std::optional<unsigned int> rollbackBenchRuns;
+        MazeGenerator::Settings mazeSettings;
+        std::optional<std::uint64_t> mazeSeed;
+        std::optional<std::size_t> generateCount;
+        std::filesystem::path generateDir;
+        unsigned int generatorThreads = 0;
+
+        for (std::size_t i = 0; i < args.size(); ++i) {
+            bool hasValue = i + 1 < args.size();
+
+            if (args[i] == "--bench-render") {
+                renderBenchFrames = (hasValue && isNumber(args[i + 1])) ? std::stoul(args[++i]) : 600;
+            } else if (args[i] == "--stress") {
+                if (!stress) stress.emplace();
+                if (hasValue && isNumber(args[i + 1])) {
+                    // Counts up to the given maximum, ending on it
+                    std::size_t maxGhosts = std::stoul(args[++i]);
+                    auto& counts = stress->ghostCounts;
+                    counts.erase(std::remove_if(counts.begin(), counts.end(), [maxGhosts](std::size_t count) { return count >= maxGhosts; }), counts.end());
+                    counts.push_back(maxGhosts);
+                }
+            } else if (args[i] == "--stress-ai" && hasValue) {
+                if (!stress) stress.emplace();
+                stress->aiTypes = parseGhostTypes(args[++i]);
+            } else if (args[i] == "--versus") {
+                versus.emplace();
+            } else if (args[i] == "--net-latency" && hasValue) {
+                netLatencyMs = std::stoul(args[++i]);
+            } else if (args[i] == "--net-jitter" && hasValue) {
+                netJitterMs = std::stoul(args[++i]);
+            } else if (args[i] == "--rollback-ticks" && hasValue) {
+                if (!versus) versus.emplace();
+                versus->maxRollbackTicks = std::stoul(args[++i]);
+            } else if (args[i] == "--fuzz") {
+                if (!fuzz) fuzz.emplace();
+                if (hasValue && isNumber(args[i + 1])) fuzz->caseCount = std::stoul(args[++i]);
+            } else if (args[i] == "--fuzz-ticks" && hasValue && fuzz) {
+                fuzz->ticksPerCase = std::stoul(args[++i]);
+            } else if (args[i] == "--fuzz-seed" && hasValue && fuzz) {
+                fuzz->firstSeed = std::stoull(args[++i]);
+            } else if (args[i] == "--fuzz-threads" && hasValue && fuzz) {
+                fuzz->workerCount = std::stoul(args[++i]);
+            } else if (args[i] == "--fuzz-out" && hasValue && fuzz) {
+                fuzz->outputDir = args[++i];
+            } else if (args[i] == "--observe") {
+                if (!observe) observe.emplace();
+                if (hasValue && isNumber(args[i + 1])) observe->gameCount = std::stoul(args[++i]);
+            } else if (args[i] == "--observe-size" && hasValue && observe) {
+                observe->observation.size = parseSize(args[++i]);
+            } else if (args[i] == "--observe-format" && hasValue && observe) {
+                observe->observation.format = parseObservationFormat(args[++i]);
+            } else if (args[i] == "--observe-stack" && hasValue && observe) {
+                observe->observation.stackDepth = std::stoul(args[++i]);
+            } else if (args[i] == "--observe-ticks" && hasValue && observe) {
+                observe->ticksPerGame = std::stoul(args[++i]);
+            } else if (args[i] == "--observe-threads" && hasValue && observe) {
+                observe->workerCount = std::stoul(args[++i]);
+            } else if (args[i] == "--bench-rollback") {
+                rollbackBenchRuns = (hasValue && isNumber(args[i + 1])) ? std::stoul(args[++i]) : 600;
+            } else if (args[i] == "--pacing" && hasValue) {
+                game.setPacingMode(parsePacingMode(args[++i]));
+            } else if (args[i] == "--pacing-report") {
+                game.setReportFramePacing(true);
+            } else if (args[i] == "--input-latency") {
+                game.setMeasureInputLatency(true);
+            } else if (args[i] == "--metrics" && hasValue) {
+                if (!metrics) metrics.emplace();
+                metrics->path = args[++i];
+            } else if (args[i] == "--metrics-format" && hasValue && metrics) {
+                metrics->format = parseMetricsFormat(args[++i]);
+            } else if (args[i] == "--metrics-interval" && hasValue && metrics) {
+                metrics->interval = sf::seconds(std::stof(args[++i]));
+            } else if (args[i] == "--hot-reload") {
+                game.setHotReload(true);
+            } else if (args[i] == "--asset-pack" && hasValue) {
+                game.setAssetPack(args[++i]);
+            } else if (args[i] == "--maze" && i + 2 < args.size()) {
+                game.setMazePaths(args[i + 1], args[i + 2]);
+                i += 2;
+            } else if (args[i] == "--random-maze" && hasValue) {
+                mazeSeed = std::stoull(args[++i]);
+            } else if (args[i] == "--maze-size" && hasValue) {
+                mazeSettings.size = parseSize(args[++i]);
+            } else if (args[i] == "--tunnels" && hasValue) {
+                mazeSettings.tunnelCount = std::stoul(args[++i]);
+            } else if (args[i] == "--generate-mazes" && i + 2 < args.size()) {
+                generateCount = std::stoul(args[i + 1]);
+                generateDir = args[i + 2];
+                i += 2;
+            } else if (args[i] == "--generator-threads" && hasValue) {
+                generatorThreads = std::stoul(args[++i]);
+            } else if (args[i] == "--record" && hasValue) {
+                game.setRecordPath(args[++i]);
+            } else if (args[i] == "--capture" && hasValue) {
+                capture.emplace();
+                capture->outputDir = args[++i];
+            } else if (args[i] == "--replay" && hasValue) {
+                if (!capture) capture.emplace();
+                capture->replayPath = args[++i];
+            } else if (args[i] == "--frames" && hasValue && capture) {
+                capture->frameCount = std::stoul(args[++i]);
+            } else if (args[i] == "--raw" && capture) {
+                capture->format = FrameEncoder::Format::RAW;
+            } else if (args[i] == "--software" && capture) {
+                capture->softwareRenderer = true;
+            } else if (args[i] == "--encoder-threads" && hasValue && capture) {
+                capture->workerCount = std::stoul(args[++i]);
+            } else {
+                throw std::runtime_error("Unknown argument: " + args[i]);
+            }
+        }
+
+        if (generateCount) {
+            generateMazes(mazeSettings, mazeSeed.value_or(1), *generateCount, generateDir, generatorThreads);
+            return 0;
+        }
+        if (mazeSeed) {
+            game.setGeneratedMaze(mazeSettings, *mazeSeed);
+        }
+        if (metrics) {
+            game.setMetricsExport(*metrics);
+        }
+
+        if (fuzz) {
+            Fuzzer(game, *fuzz).run();
+        } else if (observe) {
+            ObservationBenchmark(game, *observe).run();
+        } else if (stress) {
+            StressTest(game, *stress).run();
+        } else if (rollbackBenchRuns) {
+            RollbackBenchmark(game, versus.value_or(VersusMatch::Settings()).maxRollbackTicks, *rollbackBenchRuns).run();
+        } else if (versus) {
+            LoopbackTransport transport(sf::milliseconds(netLatencyMs), sf::milliseconds(netJitterMs));
+            VersusMatch(game, transport, *versus).run();
+        } else if (renderBenchFrames) {
+            RenderBenchmark(game, *renderBenchFrames).run();
+        } else if (capture) {
+            FrameCapture(game, *capture).run();
+        } else {
+            game.run();
+        }
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
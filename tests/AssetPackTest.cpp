@@ -0,0 +1,183 @@
+#include "AssetPack.h"
+#include "Check.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+static const std::filesystem::path testDir = std::filesystem::temp_directory_path() / "pacmen_asset_pack_test";
+
+struct TestAsset {
+    std::string name;
+    std::string contents;
+    std::filesystem::path sourcePath;  // empty: packed from a file that is gone
+};
+
+// Lays the pack out the way the packer does: header, sorted index, aligned payloads
+static void writePack(const std::filesystem::path& packPath, std::vector<TestAsset> assets) {
+    std::sort(assets.begin(), assets.end(), [](const TestAsset& a, const TestAsset& b) {
+        return AssetPack::idForPath(a.name) < AssetPack::idForPath(b.name);
+    });
+
+    AssetPack::Header header{};
+    std::memcpy(header.magic, AssetPack::MAGIC, sizeof(header.magic));
+    header.version = AssetPack::VERSION;
+    header.entryCount = static_cast<std::uint32_t>(assets.size());
+
+    std::vector<AssetPack::Entry> entries;
+    std::uint64_t offset = sizeof(header) + assets.size() * sizeof(AssetPack::Entry);
+    for (const TestAsset& asset : assets) {
+        offset = (offset + AssetPack::PAYLOAD_ALIGNMENT - 1) / AssetPack::PAYLOAD_ALIGNMENT * AssetPack::PAYLOAD_ALIGNMENT;
+
+        AssetPack::Entry entry{};
+        entry.id = AssetPack::idForPath(asset.name);
+        entry.type = AssetPack::Type::RAW;
+        entry.offset = offset;
+        entry.size = asset.contents.size();
+        if (!asset.sourcePath.empty()) {
+            entry.sourceSize = std::filesystem::file_size(asset.sourcePath);
+            entry.sourceModified = static_cast<std::int64_t>(std::filesystem::last_write_time(asset.sourcePath).time_since_epoch().count());
+        }
+        entries.push_back(entry);
+        offset += entry.size;
+    }
+
+    std::ofstream file(packPath, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(AssetPack::Entry)));
+    for (std::size_t i = 0; i < assets.size(); ++i) {
+        while (static_cast<std::uint64_t>(file.tellp()) < entries[i].offset) file.put('\0');
+        file.write(assets[i].contents.data(), static_cast<std::streamsize>(assets[i].contents.size()));
+    }
+}
+
+static void writeFile(const std::filesystem::path& path, const std::string& contents) {
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << contents;
+}
+
+static std::string payload(const AssetPack& pack, const AssetPack::Entry& entry) {
+    return std::string(reinterpret_cast<const char*>(pack.getPayload(entry)), entry.size);
+}
+
+static void testFindsEveryAsset() {
+    const std::filesystem::path packPath = testDir / "lookup.pack";
+    std::vector<TestAsset> assets;
+    for (int i = 0; i < 40; ++i) {
+        assets.push_back({"assets/sounds/sound" + std::to_string(i) + ".wav", std::string(i * 3 + 1, static_cast<char>('a' + i % 26)), ""});
+    }
+    writePack(packPath, assets);
+
+    AssetPack pack;
+    CHECK(pack.open(packPath));
+    CHECK(pack.isOpen() && pack.getPath() == packPath);
+
+    for (const TestAsset& asset : assets) {
+        const AssetPack::Entry* entry = pack.find(asset.name);
+        CHECK(entry && payload(pack, *entry) == asset.contents);
+        CHECK(entry && entry->offset % AssetPack::PAYLOAD_ALIGNMENT == 0);
+    }
+
+    // IDs come from the normalised path
+    CHECK(pack.find("./assets//sounds/sound7.wav") == pack.find("assets/sounds/sound7.wav"));
+
+    CHECK(!pack.find("assets/sounds/sound40.wav"));
+    CHECK(!pack.find(""));
+
+    pack.close();
+    CHECK(!pack.isOpen() && !pack.find("assets/sounds/sound7.wav"));
+}
+
+static void testPrefersChangedLooseFiles() {
+    const std::filesystem::path packPath = testDir / "stale.pack";
+    const std::filesystem::path soundPath = testDir / "assets/sounds/credit.wav";
+    const std::filesystem::path imagePath = testDir / "assets/textures/atlas.png";
+    const std::filesystem::path fontPath = testDir / "assets/fonts/font.ttf";
+    writeFile(soundPath, "sound");
+    writeFile(imagePath, "image");
+    writeFile(fontPath, "font");
+    writePack(packPath, {{soundPath.string(), "packed sound", soundPath},
+                         {imagePath.string(), "packed image", imagePath},
+                         {fontPath.string(), "packed font", fontPath}});
+
+    // A loose file edited since packing is loaded instead
+    writeFile(soundPath, "sound, longer");
+    writeFile(imagePath, "IMAGE");  // same size, newer write time
+    std::filesystem::last_write_time(imagePath, std::filesystem::last_write_time(imagePath) + std::chrono::seconds(5));
+
+    AssetPack pack;
+    CHECK(pack.open(packPath));
+    CHECK(pack.find(soundPath) == nullptr);
+    CHECK(pack.find(imagePath) == nullptr);
+    CHECK(pack.find(fontPath) != nullptr);
+
+    // Each file is only looked at on its asset's first lookup
+    writeFile(fontPath, "font, edited");
+    std::filesystem::remove(soundPath);
+    CHECK(pack.find(fontPath) != nullptr);
+    CHECK(pack.find(soundPath) == nullptr);
+
+    // Reopening looks again; with no loose copy at all, the pack is all there is
+    CHECK(pack.open(packPath));
+    CHECK(pack.find(fontPath) == nullptr);
+    CHECK(pack.find(soundPath) != nullptr);
+    CHECK(pack.find(imagePath) == nullptr);
+}
+
+static void testRejectsBrokenPacks() {
+    const std::filesystem::path packPath = testDir / "broken.pack";
+    writePack(packPath, {{"a", "first", ""}, {"b", "second", ""}});
+
+    std::string bytes;
+    {
+        std::ifstream file(packPath, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    auto opensWith = [&](const std::string& contents) {
+        writeFile(packPath, contents);
+        AssetPack pack;
+        return pack.open(packPath);
+    };
+
+    CHECK(opensWith(bytes));
+    CHECK(!opensWith(bytes.substr(0, bytes.size() - 1)));  // last payload cut short
+    CHECK(!opensWith(bytes.substr(0, 8)));                 // not even a header
+
+    std::string wrongMagic = bytes;
+    wrongMagic[0] = 'X';
+    CHECK(!opensWith(wrongMagic));
+
+    std::string oldVersion = bytes;
+    std::uint32_t version = AssetPack::VERSION - 1;
+    std::memcpy(&oldVersion[offsetof(AssetPack::Header, version)], &version, sizeof(version));
+    CHECK(!opensWith(oldVersion));
+
+    // Swapping the two entries breaks the sorted index that lookups rely on
+    std::string unsorted = bytes;
+    std::swap_ranges(unsorted.begin() + sizeof(AssetPack::Header),
+                     unsorted.begin() + sizeof(AssetPack::Header) + sizeof(AssetPack::Entry),
+                     unsorted.begin() + sizeof(AssetPack::Header) + sizeof(AssetPack::Entry));
+    CHECK(!opensWith(unsorted));
+
+    AssetPack pack;
+    CHECK(!pack.open(testDir / "missing.pack"));
+}
+
+int main() {
+    std::filesystem::remove_all(testDir);
+    std::filesystem::create_directories(testDir);
+
+    testFindsEveryAsset();
+    testPrefersChangedLooseFiles();
+    testRejectsBrokenPacks();
+
+    std::filesystem::remove_all(testDir);
+    return checkResult();
+}
@@ -0,0 +1,28 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <iostream>
+
+// Bare assertions for the test executables. A failed CHECK is reported and the
+// test carries on; main() returns checkResult() so CTest sees the failures.
+namespace check {
+    inline int failures = 0;
+}
+
+#define CHECK(condition)                                                                          \
+    do {                                                                                          \
+        if (!(condition)) {                                                                       \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed" << std::endl; \
+            ++check::failures;                                                                    \
+        }                                                                                         \
+    } while (false)
+
+inline int checkResult() {
+    if (check::failures > 0) {
+        std::cerr << check::failures << " checks failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+#endif
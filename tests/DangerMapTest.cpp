@@ -0,0 +1,203 @@
+#include "Check.h"
+#include "DangerMap.h"
+#include "Entity.h"
+#include "MazeGenerator.h"
+#include "MazeMap.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+// '#' is a wall; the middle row is a tunnel and the bottom-right pocket is cut off
+static const std::vector<std::string> testMaze = {
+    "############",
+    "#....#.....#",
+    "#.##.#.###.#",
+    "#..........#",
+    "...##..##...",
+    "#.#......#.#",
+    "#.#.####.#.#",
+    "#........#.#",
+    "##########.#",
+    "#########.##",
+    "############",
+};
+
+static std::shared_ptr<const MazeLayout> layoutFromRows(const std::vector<std::string>& rows) {
+    std::vector<int> collision;
+    for (const std::string& row : rows) {
+        for (char tile : row) {
+            collision.push_back(tile == '#' ? 1 : 0);
+        }
+    }
+    std::vector<int> pellets(collision.size(), 0);
+    return MazeLayout::create(collision, pellets, {static_cast<unsigned int>(rows[0].size()), static_cast<unsigned int>(rows.size())});
+}
+
+// One ghost at a time: every (tile, heading) it can be in after exactly k
+// moves, for k = 0, 1, ..., until a step reaches no state it has not been in
+static std::vector<unsigned int> bruteForceArrival(const MazeMap& map, const DangerMap::Source& source) {
+    const int width = static_cast<int>(map.getWidth());
+    const int height = static_cast<int>(map.getHeight());
+    std::vector<unsigned int> arrival(static_cast<std::size_t>(width) * height, DangerMap::NEVER);
+
+    const MovementDir headings[4] = {MovementDir::UP, MovementDir::DOWN, MovementDir::LEFT, MovementDir::RIGHT};
+    const sf::Vector2i steps[4] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+    auto reverseOf = [](int heading) { return heading ^ 1; };
+
+    struct State {
+        sf::Vector2i tile;
+        int heading;  // 4: none yet
+    };
+
+    sf::Vector2i start = {((source.tile.x % width) + width) % width, source.tile.y};
+    if (map.isWall(start)) return arrival;
+
+    int startHeading = 4;
+    for (int heading = 0; heading < 4; ++heading) {
+        if (headings[heading] == source.heading) startHeading = heading;
+    }
+
+    std::vector<bool> seen(arrival.size() * 5, false);
+    std::vector<State> states = {{start, startHeading}};
+    seen[map.convert2DCoords(start) * 5 + startHeading] = true;
+
+    for (unsigned int moves = 0; !states.empty(); ++moves) {
+        for (const State& state : states) {
+            unsigned int& tileArrival = arrival[map.convert2DCoords(state.tile)];
+            tileArrival = std::min(tileArrival, source.delayTicks + moves * source.ticksPerTile);
+        }
+
+        std::vector<State> next;
+        for (const State& state : states) {
+            for (int heading = 0; heading < 4; ++heading) {
+                if (state.heading != 4 && heading == reverseOf(state.heading)) continue;
+
+                sf::Vector2i tile = state.tile + steps[heading];
+                if (tile.y < 0 || tile.y >= height) continue;
+                tile.x = (tile.x + width) % width;
+                if (map.isWall(tile)) continue;
+
+                std::size_t key = static_cast<std::size_t>(map.convert2DCoords(tile)) * 5 + heading;
+                if (seen[key]) continue;
+                seen[key] = true;
+                next.push_back({tile, heading});
+            }
+        }
+        states = std::move(next);
+    }
+
+    return arrival;
+}
+
+static bool matchesBruteForce(const MazeMap& map, const std::vector<DangerMap::Source>& sources) {
+    std::vector<unsigned int> expected(static_cast<std::size_t>(map.getWidth()) * map.getHeight(), DangerMap::NEVER);
+    for (const DangerMap::Source& source : sources) {
+        std::vector<unsigned int> ghostArrival = bruteForceArrival(map, source);
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            expected[i] = std::min(expected[i], ghostArrival[i]);
+        }
+    }
+
+    DangerMap danger;
+    std::vector<DangerMap::Source> reordered = sources;
+    danger.compute(map, reordered);
+
+    for (int y = 0; y < static_cast<int>(map.getHeight()); ++y) {
+        for (int x = 0; x < static_cast<int>(map.getWidth()); ++x) {
+            if (danger.arrivalTick({x, y}) != expected[map.convert2DCoords({x, y})]) return false;
+        }
+    }
+    return true;
+}
+
+static std::vector<DangerMap::Source> randomSources(const MazeMap& map, std::mt19937& random, unsigned int count) {
+    const MovementDir headings[5] = {MovementDir::UP, MovementDir::DOWN, MovementDir::LEFT, MovementDir::RIGHT, MovementDir::STATIC};
+    const unsigned int speeds[3] = {2, 3, 7};
+
+    std::vector<DangerMap::Source> sources;
+    while (sources.size() < count) {
+        sf::Vector2i tile(static_cast<int>(random() % map.getWidth()), static_cast<int>(random() % map.getHeight()));
+        if (map.isWall(tile)) continue;
+        sources.push_back({tile, headings[random() % 5], speeds[random() % 3], static_cast<unsigned int>(random() % 20)});
+    }
+    return sources;
+}
+
+static void testSingleGhostNeverReverses() {
+    sf::Texture texture;
+    MazeMap map;
+    map.loadMaze(layoutFromRows(testMaze), texture, 8, std::nullopt, {0, 0});
+
+    // Heading right along the top-left corridor: the tile just behind it can
+    // only be reached the long way round the block
+    DangerMap danger;
+    std::vector<DangerMap::Source> sources = {{{2, 1}, MovementDir::RIGHT, 2, 0}};
+    danger.compute(map, sources);
+    CHECK(danger.arrivalTick({2, 1}) == 0);
+    CHECK(danger.arrivalTick({3, 1}) == 2);
+    CHECK(danger.arrivalTick({1, 1}) > 2 * 2);
+
+    // Left alone it may leave either way
+    sources = {{{2, 1}, MovementDir::STATIC, 2, 0}};
+    danger.compute(map, sources);
+    CHECK(danger.arrivalTick({1, 1}) == 2);
+
+    CHECK(matchesBruteForce(map, {{{2, 1}, MovementDir::RIGHT, 2, 0}}));
+    CHECK(matchesBruteForce(map, {{{6, 4}, MovementDir::UP, 3, 5}}));
+}
+
+static void testTunnelsWallsAndPockets() {
+    sf::Texture texture;
+    MazeMap map;
+    map.loadMaze(layoutFromRows(testMaze), texture, 8, std::nullopt, {0, 0});
+
+    // Heading left out of the tunnel comes back in on the right
+    DangerMap danger;
+    std::vector<DangerMap::Source> sources = {{{0, 4}, MovementDir::LEFT, 2, 0}};
+    danger.compute(map, sources);
+    CHECK(danger.arrivalTick({11, 4}) == 2);
+    CHECK(danger.arrivalTick({-1, 4}) == 2);
+    CHECK(danger.arrivalTick({12, 4}) == 0);
+
+    CHECK(danger.arrivalTick({0, 0}) == DangerMap::NEVER);   // wall
+    CHECK(danger.arrivalTick({9, 9}) == DangerMap::NEVER);   // the cut-off pocket
+    CHECK(danger.arrivalTick({3, -1}) == DangerMap::NEVER);  // off the maze
+    CHECK(danger.arrivalTick({3, 11}) == DangerMap::NEVER);
+
+    // A ghost starting on a wall adds nothing
+    sources = {{{0, 0}, MovementDir::STATIC, 2, 0}};
+    danger.compute(map, sources);
+    CHECK(danger.arrivalTick({1, 1}) == DangerMap::NEVER);
+}
+
+static void testManyGhostsMatchBruteForce() {
+    std::mt19937 random(11);
+
+    sf::Texture texture;
+    MazeMap map;
+    map.loadMaze(layoutFromRows(testMaze), texture, 8, std::nullopt, {0, 0});
+    for (int round = 0; round < 50; ++round) {
+        CHECK(matchesBruteForce(map, randomSources(map, random, 1 + random() % 6)));
+    }
+
+    // Full-size mazes with several tunnels; speeds repeat, so sources share searches
+    MazeGenerator::Settings settings;
+    settings.tunnelCount = 3;
+    MazeGenerator generator(settings);
+    for (std::uint64_t seed = 1; seed <= 5; ++seed) {
+        GeneratedMaze maze = generator.generate(seed);
+        MazeMap generated;
+        generated.loadMaze(MazeLayout::create(maze.collisionData, maze.pelletData, maze.size), texture, 8, std::nullopt, {0, 0});
+        for (int round = 0; round < 4; ++round) {
+            CHECK(matchesBruteForce(generated, randomSources(generated, random, 4 + random() % 60)));
+        }
+    }
+}
+
+int main() {
+    testSingleGhostNeverReverses();
+    testTunnelsWallsAndPockets();
+    testManyGhostsMatchBruteForce();
+    return checkResult();
+}
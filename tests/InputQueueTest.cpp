@@ -0,0 +1,74 @@
+#include "Check.h"
+#include "InputQueue.h"
+
+static sf::Event keyPressed(sf::Keyboard::Key key) {
+    sf::Event::KeyPressed event{};
+    event.code = key;
+    return event;
+}
+
+static sf::Event keyReleased(sf::Keyboard::Key key) {
+    sf::Event::KeyReleased event{};
+    event.code = key;
+    return event;
+}
+
+static void testMapsMovementKeys() {
+    InputQueue queue;
+    CHECK(queue.pushEvent(keyPressed(sf::Keyboard::Key::Up), sf::milliseconds(1)));
+    CHECK(queue.pushEvent(keyPressed(sf::Keyboard::Key::A), sf::milliseconds(2)));
+    CHECK(queue.pushEvent(keyReleased(sf::Keyboard::Key::Up), sf::milliseconds(3)));
+
+    // Anything but a movement key is left for the caller
+    CHECK(!queue.pushEvent(keyPressed(sf::Keyboard::Key::Space), sf::milliseconds(4)));
+    CHECK(!queue.pushEvent(sf::Event::Closed{}, sf::milliseconds(5)));
+
+    std::vector<InputEvent> out;
+    queue.popUntil(sf::milliseconds(10), out);
+    CHECK(out.size() == 3);
+    CHECK(out[0].direction == MovementDir::UP && out[0].pressed && out[0].timestamp == sf::milliseconds(1));
+    CHECK(out[1].direction == MovementDir::LEFT && out[1].pressed);
+    CHECK(out[2].direction == MovementDir::UP && !out[2].pressed);
+    CHECK(queue.isEmpty());
+}
+
+static void testKeySetsSplitThePlayers() {
+    InputQueue arrows(InputQueue::KeySet::ARROWS);
+    InputQueue wasd(InputQueue::KeySet::WASD);
+
+    CHECK(arrows.pushEvent(keyPressed(sf::Keyboard::Key::Down), sf::Time::Zero));
+    CHECK(!arrows.pushEvent(keyPressed(sf::Keyboard::Key::S), sf::Time::Zero));
+    CHECK(wasd.pushEvent(keyPressed(sf::Keyboard::Key::S), sf::Time::Zero));
+    CHECK(!wasd.pushEvent(keyPressed(sf::Keyboard::Key::Down), sf::Time::Zero));
+
+    std::vector<InputEvent> out;
+    wasd.popUntil(sf::Time::Zero, out);
+    CHECK(out.size() == 1 && out[0].direction == MovementDir::DOWN);
+}
+
+static void testPopsOnlyUpToTheDeadline() {
+    InputQueue queue;
+    queue.push({MovementDir::LEFT, true, sf::milliseconds(10)});
+    queue.push({MovementDir::RIGHT, true, sf::milliseconds(20)});
+    queue.push({MovementDir::LEFT, false, sf::milliseconds(30)});
+
+    std::vector<InputEvent> out = {{MovementDir::UP, true, sf::Time::Zero}};
+    queue.popUntil(sf::milliseconds(20), out);
+    CHECK(out.size() == 2);  // cleared first, then inclusive of the deadline
+    CHECK(out[0].direction == MovementDir::LEFT && out[1].direction == MovementDir::RIGHT);
+    CHECK(!queue.isEmpty());
+
+    queue.popUntil(sf::milliseconds(29), out);
+    CHECK(out.empty());
+
+    queue.popUntil(sf::milliseconds(30), out);
+    CHECK(out.size() == 1 && !out[0].pressed);
+    CHECK(queue.isEmpty());
+}
+
+int main() {
+    testMapsMovementKeys();
+    testKeySetsSplitThePlayers();
+    testPopsOnlyUpToTheDeadline();
+    return checkResult();
+}
@@ -0,0 +1,137 @@
+#include "Check.h"
+#include "MazeGenerator.h"
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+static bool sameMaze(const GeneratedMaze& a, const GeneratedMaze& b) {
+    return a.seed == b.seed && a.size == b.size && a.collisionData == b.collisionData && a.pelletData == b.pelletData &&
+           a.houseDoorTile == b.houseDoorTile && a.houseInterior == b.houseInterior &&
+           a.pacmanStartTile == b.pacmanStartTile && a.ghostStartTiles == b.ghostStartTiles;
+}
+
+static bool throwsForSize(sf::Vector2u size) {
+    MazeGenerator::Settings settings;
+    settings.size = size;
+    try {
+        MazeGenerator generator(settings);
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+static void testEverySizeAndSeedVerifies() {
+    const sf::Vector2u sizes[] = {{20, 17}, {22, 18}, {24, 20}, {26, 23}, {28, 31}, {30, 31}, {40, 40}, {56, 31}, {64, 64}};
+
+    for (sf::Vector2u size : sizes) {
+        for (unsigned int tunnelCount = 0; tunnelCount <= 3; ++tunnelCount) {
+            MazeGenerator::Settings settings;
+            settings.size = size;
+            settings.tunnelCount = tunnelCount;
+            MazeGenerator generator(settings);
+
+            for (std::uint64_t seed = 1; seed <= 25; ++seed) {
+                GeneratedMaze maze = generator.generate(seed);
+                CHECK(maze.size == size && maze.seed == seed);
+                CHECK(MazeGenerator::verify(maze));
+                CHECK(sameMaze(maze, generator.generate(seed)));
+            }
+        }
+    }
+}
+
+static void testVerifyCatchesBrokenMazes() {
+    MazeGenerator generator(MazeGenerator::Settings{});
+    const GeneratedMaze maze = generator.generate(7);
+    const int width = static_cast<int>(maze.size.x);
+    auto index = [&](sf::Vector2i tile) { return tile.x + tile.y * width; };
+    auto mirror = [&](sf::Vector2i tile) { return sf::Vector2i(width - 1 - tile.x, tile.y); };
+
+    GeneratedMaze lopsided = maze;
+    lopsided.pelletData[index(maze.pacmanStartTile)] = 2;
+    CHECK(!MazeGenerator::verify(lopsided));
+
+    GeneratedMaze shutDoor = maze;
+    shutDoor.collisionData[index(maze.houseDoorTile)] = 1;
+    shutDoor.collisionData[index(mirror(maze.houseDoorTile))] = 1;
+    CHECK(!MazeGenerator::verify(shutDoor));
+
+    // Pac-Man may not start in the house, nor Pinky outside it
+    GeneratedMaze pacmanInHouse = maze;
+    pacmanInHouse.pacmanStartTile = maze.ghostStartTiles[1];
+    CHECK(!MazeGenerator::verify(pacmanInHouse));
+
+    GeneratedMaze pinkyOutside = maze;
+    pinkyOutside.ghostStartTiles[1] = maze.pacmanStartTile;
+    CHECK(!MazeGenerator::verify(pinkyOutside));
+
+    GeneratedMaze walledInterior = maze;
+    sf::Vector2i corner = maze.houseInterior.position;
+    walledInterior.collisionData[index(corner)] = 1;
+    walledInterior.collisionData[index(mirror(corner))] = 1;
+    CHECK(!MazeGenerator::verify(walledInterior));
+
+    GeneratedMaze truncated = maze;
+    truncated.pelletData.pop_back();
+    CHECK(!MazeGenerator::verify(truncated));
+}
+
+static void testBatchIgnoresThreadCount() {
+    MazeGenerator::Settings settings;
+    settings.size = {40, 40};
+    settings.tunnelCount = 2;
+    MazeGenerator generator(settings);
+
+    auto generateAll = [&](unsigned int threadCount) {
+        std::map<std::uint64_t, GeneratedMaze> mazes;
+        std::mutex mazesMutex;
+        generator.generateBatch(100, 64, threadCount, [&](const GeneratedMaze& maze) {
+            std::lock_guard<std::mutex> lock(mazesMutex);
+            mazes.emplace(maze.seed, maze);
+        });
+        return mazes;
+    };
+
+    const std::map<std::uint64_t, GeneratedMaze> serial = generateAll(1);
+    CHECK(serial.size() == 64 && serial.begin()->first == 100);
+
+    for (unsigned int threadCount : {2u, 4u, 7u}) {
+        std::map<std::uint64_t, GeneratedMaze> parallel = generateAll(threadCount);
+        CHECK(parallel.size() == serial.size());
+        for (const auto& [seed, maze] : serial) {
+            auto match = parallel.find(seed);
+            CHECK(match != parallel.end() && sameMaze(maze, match->second));
+        }
+    }
+
+    // An exception on a worker reaches the caller
+    bool rethrown = false;
+    try {
+        generator.generateBatch(1, 16, 4, [](const GeneratedMaze& maze) {
+            if (maze.seed == 9) throw std::runtime_error("consumer failed");
+        });
+    } catch (const std::runtime_error&) {
+        rethrown = true;
+    }
+    CHECK(rethrown);
+}
+
+static void testRejectsBadSizes() {
+    CHECK(throwsForSize({29, 31}));  // odd width
+    CHECK(throwsForSize({21, 17}));
+    CHECK(throwsForSize({18, 31}));  // too narrow for the house and ring road
+    CHECK(throwsForSize({28, 16}));  // too short
+    CHECK(throwsForSize({0, 0}));
+    CHECK(!throwsForSize({20, 17}));
+    CHECK(!throwsForSize({28, 31}));
+}
+
+int main() {
+    testEverySizeAndSeedVerifies();
+    testVerifyCatchesBrokenMazes();
+    testBatchIgnoresThreadCount();
+    testRejectsBadSizes();
+    return checkResult();
+}
@@ -0,0 +1,142 @@
+#include "Check.h"
+#include "FrameStack.h"
+#include "ObservationEncoder.h"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+// Plain box average, rounding to nearest, then the per-pixel conversion
+static std::vector<std::uint8_t> referenceEncode(const std::vector<std::uint8_t>& source, sf::Vector2u sourceSize,
+                                                 sf::Vector2u outputSize, ObservationEncoder::Format format) {
+    std::vector<std::uint8_t> output(static_cast<std::size_t>(outputSize.x) * outputSize.y);
+
+    for (unsigned int outputY = 0; outputY < outputSize.y; ++outputY) {
+        unsigned int top = outputY * sourceSize.y / outputSize.y;
+        unsigned int bottom = (outputY + 1) * sourceSize.y / outputSize.y;
+
+        for (unsigned int outputX = 0; outputX < outputSize.x; ++outputX) {
+            unsigned int left = outputX * sourceSize.x / outputSize.x;
+            unsigned int right = (outputX + 1) * sourceSize.x / outputSize.x;
+            unsigned int boxPixels = (bottom - top) * (right - left);
+
+            unsigned int average[3];
+            for (unsigned int channel = 0; channel < 3; ++channel) {
+                unsigned int total = 0;
+                for (unsigned int y = top; y < bottom; ++y) {
+                    for (unsigned int x = left; x < right; ++x) {
+                        total += source[(static_cast<std::size_t>(y) * sourceSize.x + x) * 4 + channel];
+                    }
+                }
+                average[channel] = (total + boxPixels / 2) / boxPixels;
+            }
+
+            std::uint8_t& value = output[static_cast<std::size_t>(outputY) * outputSize.x + outputX];
+            if (format == ObservationEncoder::Format::GRAYSCALE) {
+                value = static_cast<std::uint8_t>((77 * average[0] + 150 * average[1] + 29 * average[2] + 128) >> 8);
+            } else {
+                value = static_cast<std::uint8_t>((average[0] & 0xE0) | ((average[1] & 0xE0) >> 3) | (average[2] >> 6));
+            }
+        }
+    }
+
+    return output;
+}
+
+static void testEncoderMatchesBoxAverage() {
+    const sf::Vector2u sourceSize = {224, 248};
+    std::vector<std::uint8_t> source(static_cast<std::size_t>(sourceSize.x) * sourceSize.y * 4);
+    std::mt19937 random(7);
+    for (std::uint8_t& byte : source) {
+        byte = static_cast<std::uint8_t>(random());
+    }
+
+    // Uneven boxes, whole-number boxes, odd widths that leave a scalar tail, and no filtering at all
+    const sf::Vector2u outputSizes[] = {{84, 84}, {112, 124}, {17, 13}, {1, 1}, {224, 248}};
+    for (sf::Vector2u outputSize : outputSizes) {
+        for (ObservationEncoder::Format format : {ObservationEncoder::Format::GRAYSCALE, ObservationEncoder::Format::RGB332}) {
+            ObservationEncoder encoder(sourceSize, outputSize, format);
+            CHECK(encoder.getFrameBytes() == static_cast<std::size_t>(outputSize.x) * outputSize.y);
+
+            std::vector<std::uint8_t> output(encoder.getFrameBytes());
+            encoder.encode(source.data(), output.data());
+            CHECK(output == referenceEncode(source, sourceSize, outputSize, format));
+        }
+    }
+}
+
+static void testEncoderKeepsFlatColours() {
+    // White stays 255 and black 0 whatever the box size
+    const sf::Vector2u sourceSize = {30, 20};
+    std::vector<std::uint8_t> white(sourceSize.x * sourceSize.y * 4, 255);
+    std::vector<std::uint8_t> output(7 * 6);
+
+    ObservationEncoder gray(sourceSize, {7, 6}, ObservationEncoder::Format::GRAYSCALE);
+    gray.encode(white.data(), output.data());
+    CHECK(output == std::vector<std::uint8_t>(output.size(), 255));
+
+    ObservationEncoder palette(sourceSize, {7, 6}, ObservationEncoder::Format::RGB332);
+    std::vector<std::uint8_t> black(white.size(), 0);
+    palette.encode(black.data(), output.data());
+    CHECK(output == std::vector<std::uint8_t>(output.size(), 0));
+}
+
+static void testEncoderRejectsBadSizes() {
+    auto throws = [](sf::Vector2u sourceSize, sf::Vector2u outputSize) {
+        try {
+            ObservationEncoder encoder(sourceSize, outputSize, ObservationEncoder::Format::GRAYSCALE);
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+
+    CHECK(throws({224, 248}, {0, 84}));
+    CHECK(throws({224, 248}, {300, 84}));
+    CHECK(throws({0, 0}, {1, 1}));
+    CHECK(throws({4, 600}, {4, 2}));  // more rows per box than the 16-bit sums hold
+    CHECK(!throws({224, 248}, {84, 84}));
+}
+
+static void testFrameStackRing() {
+    const std::size_t frameBytes = 4;
+    std::vector<std::uint8_t> memory(frameBytes * 3, 0);
+    FrameStack stack(memory.data(), frameBytes, 3);
+
+    auto pushFilled = [&](std::uint8_t value) {
+        std::uint8_t* frame = stack.nextFrame();
+        CHECK(frame >= memory.data() && frame + frameBytes <= memory.data() + memory.size());
+        std::fill(frame, frame + frameBytes, value);
+        stack.push();
+    };
+
+    pushFilled(1);
+    stack.fillWithNewest();
+    for (unsigned int age = 0; age < 3; ++age) {
+        CHECK(stack.getFrame(age)[0] == 1);
+    }
+
+    pushFilled(2);
+    pushFilled(3);
+    CHECK(stack.getFrame(0)[0] == 3 && stack.getFrame(1)[0] == 2 && stack.getFrame(2)[0] == 1);
+
+    // The fourth frame replaces the oldest slot in place; the others never move
+    const std::uint8_t* newestBefore = stack.getFrame(0);
+    pushFilled(4);
+    CHECK(stack.getFrame(0)[0] == 4 && stack.getFrame(1)[0] == 3 && stack.getFrame(2)[0] == 2);
+    CHECK(stack.getFrame(1) == newestBefore);
+    CHECK(stack.getDepth() == 3);
+
+    // The caller's memory holds every frame, oldest right after the newest
+    unsigned int newest = stack.getNewestSlot();
+    CHECK(memory[newest * frameBytes] == 4);
+    CHECK(memory[((newest + 1) % 3) * frameBytes] == 2);
+}
+
+int main() {
+    testEncoderMatchesBoxAverage();
+    testEncoderKeepsFlatColours();
+    testEncoderRejectsBadSizes();
+    testFrameStackRing();
+    return checkResult();
+}
@@ -0,0 +1,94 @@
+#include "Check.h"
+#include "OccupancyGrid.h"
+#include <algorithm>
+#include <vector>
+
+static std::vector<unsigned int> occupants(const OccupancyGrid& grid, sf::Vector2i tile) {
+    std::vector<unsigned int> slots;
+    grid.forEachInTile(tile, [&](unsigned int slot) { slots.push_back(slot); });
+    std::sort(slots.begin(), slots.end());
+    return slots;
+}
+
+static void testPlaceMoveAndRemove() {
+    OccupancyGrid grid;
+    grid.reset({28, 31}, 4);
+    CHECK(grid.firstInTile({5, 5}) == OccupancyGrid::NONE);
+
+    grid.place(0, {5, 5});
+    grid.place(1, {5, 5});
+    grid.place(2, {6, 5});
+    CHECK(occupants(grid, {5, 5}) == std::vector<unsigned int>({0, 1}));
+    CHECK(occupants(grid, {6, 5}) == std::vector<unsigned int>({2}));
+
+    // Moving unlinks from the old tile, whichever end of its list the slot was at
+    grid.place(1, {6, 5});
+    grid.place(0, {6, 5});
+    CHECK(occupants(grid, {5, 5}).empty());
+    CHECK(occupants(grid, {6, 5}) == std::vector<unsigned int>({0, 1, 2}));
+
+    // Placing a slot in the tile it is already in changes nothing
+    grid.place(0, {6, 5});
+    CHECK(occupants(grid, {6, 5}) == std::vector<unsigned int>({0, 1, 2}));
+
+    // From the middle of the list
+    int middle = grid.nextInTile(static_cast<unsigned int>(grid.firstInTile({6, 5})));
+    grid.remove(static_cast<unsigned int>(middle));
+    CHECK(occupants(grid, {6, 5}).size() == 2);
+    CHECK(grid.nextInTile(static_cast<unsigned int>(middle)) == OccupancyGrid::NONE);
+
+    // Removing a slot that is not placed is harmless
+    grid.remove(3);
+    grid.remove(static_cast<unsigned int>(middle));
+    CHECK(occupants(grid, {6, 5}).size() == 2);
+}
+
+static void testWrapsAndClampsTiles() {
+    OccupancyGrid grid;
+    grid.reset({28, 31}, 3);
+
+    // Tunnels wrap horizontally; rows above or below the maze clamp to its edge
+    grid.place(0, {-1, 14});
+    grid.place(1, {28, 14});
+    grid.place(2, {3, -4});
+    CHECK(occupants(grid, {27, 14}) == std::vector<unsigned int>({0}));
+    CHECK(occupants(grid, {0, 14}) == std::vector<unsigned int>({1}));
+    CHECK(occupants(grid, {3, 0}) == std::vector<unsigned int>({2}));
+    CHECK(occupants(grid, {55, 14}) == std::vector<unsigned int>({0}));
+}
+
+static void testVisitMayMoveTheSlot() {
+    OccupancyGrid grid;
+    grid.reset({4, 4}, 3);
+    for (unsigned int slot = 0; slot < 3; ++slot) {
+        grid.place(slot, {1, 1});
+    }
+
+    unsigned int visited = 0;
+    grid.forEachInTile({1, 1}, [&](unsigned int slot) {
+        grid.place(slot, {2, 2});
+        visited++;
+    });
+    CHECK(visited == 3);
+    CHECK(occupants(grid, {1, 1}).empty());
+    CHECK(occupants(grid, {2, 2}).size() == 3);
+}
+
+static void testResetEmptiesTheGrid() {
+    OccupancyGrid grid;
+    grid.place(0, {0, 0});  // before any reset: ignored
+    CHECK(grid.firstInTile({0, 0}) == OccupancyGrid::NONE);
+
+    grid.reset({4, 4}, 2);
+    grid.place(0, {1, 2});
+    grid.reset({4, 4}, 2);
+    CHECK(grid.firstInTile({1, 2}) == OccupancyGrid::NONE);
+}
+
+int main() {
+    testPlaceMoveAndRemove();
+    testWrapsAndClampsTiles();
+    testVisitMayMoveTheSlot();
+    testResetEmptiesTheGrid();
+    return checkResult();
+}
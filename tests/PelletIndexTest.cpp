@@ -0,0 +1,157 @@
+#include "Check.h"
+#include "MazeGenerator.h"
+#include "MazeMap.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+// '#' is a wall, 'o' a pellet; the middle row is a tunnel and the pellet at
+// the bottom right sits in a pocket nothing else can reach
+static const std::vector<std::string> testMaze = {
+    "############",
+    "#o...#....o#",
+    "#.##.#.##..#",
+    "#...o...o..#",
+    "o..##..##..o",
+    "#.#......#.#",
+    "#.#.####.#.#",
+    "#o.......#.#",
+    "##########.#",
+    "#########o##",
+    "############",
+};
+
+static std::shared_ptr<const MazeLayout> layoutFromRows(const std::vector<std::string>& rows) {
+    std::vector<int> collision;
+    std::vector<int> pellets;
+    for (const std::string& row : rows) {
+        for (char tile : row) {
+            collision.push_back(tile == '#' ? 1 : 0);
+            pellets.push_back(tile == 'o' ? 1 : 0);
+        }
+    }
+    return MazeLayout::create(collision, pellets, {static_cast<unsigned int>(rows[0].size()), static_cast<unsigned int>(rows.size())});
+}
+
+static std::vector<sf::Vector2i> pelletTiles(const MazeMap& map) {
+    std::vector<sf::Vector2i> tiles;
+    for (int y = 0; y < static_cast<int>(map.getHeight()); ++y) {
+        for (int x = 0; x < static_cast<int>(map.getWidth()); ++x) {
+            if (map.hasPellet({x, y})) tiles.push_back({x, y});
+        }
+    }
+    return tiles;
+}
+
+// Compares every tile with an index built from scratch for the same eaten
+// pellets. Ties may pick another pellet, so the nearest pellet only has to be
+// uneaten and exactly that far away.
+static bool matchesFreshIndex(const MazeMap& map) {
+    sf::Texture texture;
+    MazeMap fresh;
+    fresh.loadMaze(map.getLayout(), texture, 8, std::nullopt, {0, 0});
+    fresh.restoreEatenPellets(map.getEatenPellets());
+
+    MazeMap probe;
+    probe.loadMaze(map.getLayout(), texture, 8, std::nullopt, {0, 0});
+
+    for (int y = 0; y < static_cast<int>(map.getHeight()); ++y) {
+        for (int x = 0; x < static_cast<int>(map.getWidth()); ++x) {
+            int distance = map.getPelletDistance({x, y});
+            if (distance != fresh.getPelletDistance({x, y})) return false;
+
+            std::optional<sf::Vector2i> nearest = map.nearestPellet({x, y});
+            if (distance == MazeMap::UNREACHABLE) {
+                if (nearest) return false;
+                continue;
+            }
+
+            if (!nearest || !map.hasPellet(*nearest)) return false;
+            probe.updatePacmanDistanceField(*nearest);
+            if (probe.getPacmanDistance({x, y}) != distance) return false;
+        }
+    }
+    return true;
+}
+
+static void testHandMadeMaze() {
+    sf::Texture texture;
+    MazeMap map;
+    map.loadMaze(layoutFromRows(testMaze), texture, 8, std::nullopt, {0, 0});
+
+    CHECK(map.getPelletDistance({1, 1}) == 0);
+    CHECK(map.getPelletDistance({2, 1}) == 1);
+    CHECK(map.getPelletDistance({0, 0}) == MazeMap::UNREACHABLE);  // wall
+    CHECK(map.getPelletDistance({1, -1}) == MazeMap::UNREACHABLE);
+
+    // Both tunnel mouths hold a pellet, one step apart through the wrap
+    map.eatPellet({0, 4});
+    CHECK(map.getPelletDistance({0, 4}) == 1);
+    CHECK(map.nearestPellet({0, 4}) == sf::Vector2i(11, 4));
+    CHECK(map.nearestPellet({-1, 4}) == map.nearestPellet({11, 4}));
+
+    // The pocket's own pellet is the only one it can reach
+    CHECK(map.nearestPellet({9, 9}) == sf::Vector2i(9, 9));
+    map.eatPellet({9, 9});
+    CHECK(!map.nearestPellet({9, 9}));
+    CHECK(matchesFreshIndex(map));
+
+    for (sf::Vector2i tile : pelletTiles(map)) {
+        map.eatPellet(tile);
+        CHECK(matchesFreshIndex(map));
+    }
+    CHECK(map.dotsRemaining() == 0);
+    CHECK(map.getPelletDistance({1, 1}) == MazeMap::UNREACHABLE);
+}
+
+static void testRandomEatsAndRollbacks() {
+    std::mt19937 random(3);
+    sf::Texture texture;
+
+    MazeGenerator::Settings settings;
+    settings.tunnelCount = 2;
+    MazeGenerator generator(settings);
+
+    for (std::uint64_t seed = 1; seed <= 4; ++seed) {
+        GeneratedMaze maze = generator.generate(seed);
+        MazeMap map;
+        map.loadMaze(MazeLayout::create(maze.collisionData, maze.pelletData, maze.size), texture, 8, std::nullopt, {0, 0});
+        map.getPelletDistance({0, 0});  // builds the index, which every eat below then repairs
+
+        std::vector<MazeMap::PelletBits> history = {map.getEatenPellets()};
+        std::vector<sf::Vector2i> remaining = pelletTiles(map);
+        std::shuffle(remaining.begin(), remaining.end(), random);
+
+        while (!remaining.empty()) {
+            std::size_t bite = std::min<std::size_t>(remaining.size(), 1 + random() % 12);
+            for (std::size_t i = 0; i < bite; ++i) {
+                map.eatPellet(remaining.back());
+                remaining.pop_back();
+            }
+            history.push_back(map.getEatenPellets());
+            CHECK(matchesFreshIndex(map));
+
+            // Roll back a few steps, as a rollback or a fuzz case start does, then
+            // forward again: restores both put pellets back and take them away
+            if (history.size() > 3 && random() % 3 == 0) {
+                std::size_t back = history.size() - 2 - random() % (history.size() - 2);
+                map.restoreEatenPellets(history[back]);
+                CHECK(matchesFreshIndex(map));
+                map.restoreEatenPellets(history.back());
+                CHECK(matchesFreshIndex(map));
+            }
+        }
+
+        // All the way back to the start of the level
+        map.restoreEatenPellets(history.front());
+        CHECK(map.dotsRemaining() == map.getLayout()->getPelletCount());
+        CHECK(matchesFreshIndex(map));
+    }
+}
+
+int main() {
+    testHandMadeMaze();
+    testRandomEatsAndRollbacks();
+    return checkResult();
+}
@@ -0,0 +1,94 @@
+#include "Check.h"
+#include "Replay.h"
+#include <filesystem>
+#include <fstream>
+
+static const std::filesystem::path replayPath = std::filesystem::temp_directory_path() / "pacmen_replay_test.txt";
+
+static void testRoundTrip() {
+    Replay recording;
+    recording.record(3, {{MovementDir::LEFT, true, sf::milliseconds(40)}});
+    recording.record(7, {{MovementDir::LEFT, false, sf::milliseconds(100)}, {MovementDir::UP, true, sf::milliseconds(101)}});
+    recording.record(8, {});
+    recording.record(120, {{MovementDir::STATIC, true, sf::Time::Zero}, {MovementDir::RIGHT, true, sf::Time::Zero}});
+    CHECK(recording.saveToFile(replayPath));
+
+    Replay replay;
+    replay.record(1, {{MovementDir::DOWN, true, sf::Time::Zero}});  // replaced by the load
+    CHECK(replay.loadFromFile(replayPath));
+
+    CHECK(replay.getEntries().size() == recording.getEntries().size());
+    for (std::size_t i = 0; i < replay.getEntries().size() && i < recording.getEntries().size(); ++i) {
+        const Replay::Entry& loaded = replay.getEntries()[i];
+        const Replay::Entry& saved = recording.getEntries()[i];
+        CHECK(loaded.tick == saved.tick && loaded.direction == saved.direction && loaded.pressed == saved.pressed);
+    }
+    CHECK(replay.getLastTick() == 120);
+
+    // Each tick gets its own inputs back, in recorded order, without timestamps
+    std::vector<InputEvent> tickInput;
+    replay.inputForTick(7, tickInput);
+    CHECK(tickInput.size() == 2);
+    CHECK(tickInput[0].direction == MovementDir::LEFT && !tickInput[0].pressed);
+    CHECK(tickInput[1].direction == MovementDir::UP && tickInput[1].pressed);
+    CHECK(tickInput[1].timestamp == sf::Time::Zero);
+
+    replay.inputForTick(8, tickInput);
+    CHECK(tickInput.empty());
+    replay.inputForTick(121, tickInput);
+    CHECK(tickInput.empty());
+}
+
+static void testLoadSortsByTick() {
+    {
+        std::ofstream file(replayPath);
+        file << "9 1 1\n2 2 1\n9 3 0\n";  // up, down, left
+    }
+
+    Replay replay;
+    CHECK(replay.loadFromFile(replayPath));
+    CHECK(replay.getEntries().size() == 3);
+    CHECK(replay.getEntries()[0].tick == 2);
+
+    // Entries of one tick keep their order from the file
+    std::vector<InputEvent> tickInput;
+    replay.inputForTick(9, tickInput);
+    CHECK(tickInput.size() == 2);
+    CHECK(tickInput[0].direction == MovementDir::UP && tickInput[1].direction == MovementDir::LEFT);
+}
+
+static void testRejectsBadFiles() {
+    Replay replay;
+    replay.record(4, {{MovementDir::UP, true, sf::Time::Zero}});
+    CHECK(!replay.loadFromFile(replayPath.string() + ".missing"));
+
+    auto loads = [&](const char* contents) {
+        {
+            std::ofstream file(replayPath);
+            file << contents;
+        }
+        return replay.loadFromFile(replayPath);
+    };
+
+    CHECK(!loads("1 99 1\n"));
+    CHECK(!loads("3 1 1\n7 2"));           // cut off after the direction
+    CHECK(!loads("3 1 1\n7 2 1 0\n"));     // a field too many
+    CHECK(!loads("3 1 1\nseven 2 1\n9 3 0\n"));
+    CHECK(!loads("3 1 2\n"));              // pressed is 0 or 1
+    CHECK(!loads("-3 1 1\n"));
+
+    // None of those touched what was there
+    CHECK(replay.getEntries().size() == 1 && replay.getEntries()[0].tick == 4);
+
+    // Blank lines, e.g. a trailing one, are fine
+    CHECK(loads("3 1 1\n\n5 2 0\n\n"));
+    CHECK(replay.getEntries().size() == 2);
+}
+
+int main() {
+    testRoundTrip();
+    testLoadSortsByTick();
+    testRejectsBadFiles();
+    std::filesystem::remove(replayPath);
+    return checkResult();
+}
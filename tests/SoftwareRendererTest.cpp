@@ -0,0 +1,130 @@
+#include "Check.h"
+#include "SoftwareRenderer.h"
+#include <cstring>
+#include <random>
+#include <vector>
+
+// SFML's BlendAlpha one pixel at a time, in plain integer arithmetic
+static void referenceBlend(std::vector<std::uint8_t>& destination, sf::Vector2u destinationSize, const sf::Image& source,
+                           sf::Vector2i position) {
+    const std::uint8_t* sourcePixels = source.getPixelsPtr();
+    for (unsigned int y = 0; y < source.getSize().y; ++y) {
+        for (unsigned int x = 0; x < source.getSize().x; ++x) {
+            const std::uint8_t* pixel = sourcePixels + (static_cast<std::size_t>(y) * source.getSize().x + x) * 4;
+            std::uint8_t* target = &destination[((y + position.y) * static_cast<std::size_t>(destinationSize.x) + x + position.x) * 4];
+
+            unsigned int alpha = pixel[3];
+            for (int channel = 0; channel < 3; ++channel) {
+                target[channel] = static_cast<std::uint8_t>((pixel[channel] * alpha + target[channel] * (255 - alpha) + 127) / 255);
+            }
+            target[3] = static_cast<std::uint8_t>((255 * alpha + target[3] * (255 - alpha) + 127) / 255);
+        }
+    }
+}
+
+// Random colours; alphas are runs of transparent, opaque or anything, so rows
+// hold all-opaque and all-transparent groups of four as well as mixed ones
+static sf::Image randomImage(sf::Vector2u size, std::mt19937& random) {
+    std::vector<std::uint8_t> pixels(static_cast<std::size_t>(size.x) * size.y * 4);
+    int runLeft = 0;
+    int runKind = 0;
+    for (std::size_t i = 0; i < pixels.size(); i += 4) {
+        if (runLeft-- == 0) {
+            runLeft = static_cast<int>(random() % 9);
+            runKind = static_cast<int>(random() % 3);
+        }
+        for (int channel = 0; channel < 3; ++channel) {
+            pixels[i + channel] = static_cast<std::uint8_t>(random());
+        }
+        pixels[i + 3] = runKind == 0 ? 0 : runKind == 1 ? 255 : static_cast<std::uint8_t>(random());
+    }
+
+    sf::Image image;
+    image.resize(size, pixels.data());
+    return image;
+}
+
+static bool samePixels(const SoftwareRenderer& renderer, const std::vector<std::uint8_t>& expected) {
+    return std::memcmp(renderer.getPixels(), expected.data(), expected.size()) == 0;
+}
+
+static void testRowsMatchPixelByPixel() {
+    std::mt19937 random(5);
+
+    // Odd widths leave a scalar tail after the groups of four; offsets misalign them
+    const sf::Vector2u sourceSizes[] = {{1, 3}, {3, 2}, {5, 5}, {7, 4}, {13, 9}, {31, 7}, {61, 11}, {223, 5}};
+    for (sf::Vector2u sourceSize : sourceSizes) {
+        for (int offset : {0, 1, 3}) {
+            const sf::Vector2u size(sourceSize.x + 4, sourceSize.y + 2);
+            const sf::Image background = randomImage(size, random);
+            const sf::Image source = randomImage(sourceSize, random);
+
+            // Whole rows at once, through blendRow()
+            SoftwareRenderer rows(size);
+            rows.clear(sf::Color::Transparent);
+            rows.blit(background, sf::IntRect({0, 0}, sf::Vector2i(size)), {0.0f, 0.0f});
+            rows.blit(source, sf::IntRect({0, 0}, sf::Vector2i(sourceSize)), {static_cast<float>(offset), 1.0f});
+
+            // One pixel per blit, so never more than the scalar tail
+            SoftwareRenderer pixels(size);
+            pixels.clear(sf::Color::Transparent);
+            pixels.blit(background, sf::IntRect({0, 0}, sf::Vector2i(size)), {0.0f, 0.0f});
+            for (int y = 0; y < static_cast<int>(sourceSize.y); ++y) {
+                for (int x = 0; x < static_cast<int>(sourceSize.x); ++x) {
+                    pixels.blit(source, sf::IntRect({x, y}, {1, 1}), {static_cast<float>(x + offset), static_cast<float>(y + 1)});
+                }
+            }
+
+            std::vector<std::uint8_t> expected(static_cast<std::size_t>(size.x) * size.y * 4, 0);
+            referenceBlend(expected, size, background, {0, 0});
+            referenceBlend(expected, size, source, {offset, 1});
+
+            CHECK(samePixels(rows, expected));
+            CHECK(samePixels(pixels, expected));
+        }
+    }
+}
+
+static void testEveryAlphaAndValue() {
+    std::mt19937 random(9);
+
+    // Column x has alpha x and row y colour value y, over a background with
+    // every kind of alpha too
+    const sf::Vector2u size(256, 256);
+    std::vector<std::uint8_t> sourcePixels(static_cast<std::size_t>(size.x) * size.y * 4);
+    for (unsigned int y = 0; y < size.y; ++y) {
+        for (unsigned int x = 0; x < size.x; ++x) {
+            std::uint8_t* pixel = &sourcePixels[(static_cast<std::size_t>(y) * size.x + x) * 4];
+            pixel[0] = static_cast<std::uint8_t>(y);
+            pixel[1] = static_cast<std::uint8_t>(255 - y);
+            pixel[2] = static_cast<std::uint8_t>(y ^ 0x5A);
+            pixel[3] = static_cast<std::uint8_t>(x);
+        }
+    }
+    sf::Image source;
+    source.resize(size, sourcePixels.data());
+    const sf::Image background = randomImage(size, random);
+
+    SoftwareRenderer renderer(size);
+    renderer.clear(sf::Color(40, 80, 120, 160));
+    renderer.blit(background, sf::IntRect({0, 0}, sf::Vector2i(size)), {0.0f, 0.0f});
+    renderer.blit(source, sf::IntRect({0, 0}, sf::Vector2i(size)), {0.0f, 0.0f});
+
+    std::vector<std::uint8_t> expected(static_cast<std::size_t>(size.x) * size.y * 4);
+    for (std::size_t i = 0; i < expected.size(); i += 4) {
+        expected[i] = 40;
+        expected[i + 1] = 80;
+        expected[i + 2] = 120;
+        expected[i + 3] = 160;
+    }
+    referenceBlend(expected, size, background, {0, 0});
+    referenceBlend(expected, size, source, {0, 0});
+
+    CHECK(samePixels(renderer, expected));
+}
+
+int main() {
+    testRowsMatchPixelByPixel();
+    testEveryAlphaAndValue();
+    return checkResult();
+}
@@ -0,0 +1,60 @@
+#include "Check.h"
+#include "SweptContact.h"
+#include <cmath>
+
+static bool near(std::optional<float> time, float expected) {
+    return time && std::abs(*time - expected) < 1e-5f;
+}
+
+static void testHeadOnPassThrough() {
+    // Eight pixels each way in one tick: the centres cross mid-tick, which a
+    // check of the end positions alone would miss
+    std::optional<float> time = sweptContactTime({0.0f, 0.0f}, {8.0f, 0.0f}, {8.0f, 0.0f}, {0.0f, 0.0f}, 4.0f);
+    CHECK(near(time, 0.25f));
+}
+
+static void testAlreadyTouching() {
+    CHECK(near(sweptContactTime({0.0f, 0.0f}, {1.0f, 0.0f}, {2.0f, 0.0f}, {3.0f, 0.0f}, 4.0f), 0.0f));
+    CHECK(near(sweptContactTime({5.0f, 5.0f}, {5.0f, 5.0f}, {6.0f, 4.0f}, {6.0f, 4.0f}, 4.0f), 0.0f));
+}
+
+static void testNeverTouching() {
+    // Too far apart to meet this tick
+    CHECK(!sweptContactTime({0.0f, 0.0f}, {1.0f, 0.0f}, {20.0f, 0.0f}, {19.0f, 0.0f}, 4.0f));
+
+    // Parallel corridors: close on x the whole time but never on y
+    CHECK(!sweptContactTime({0.0f, 0.0f}, {8.0f, 0.0f}, {8.0f, 8.0f}, {0.0f, 8.0f}, 4.0f));
+
+    // Moving apart
+    CHECK(!sweptContactTime({0.0f, 0.0f}, {-2.0f, 0.0f}, {5.0f, 0.0f}, {7.0f, 0.0f}, 4.0f));
+
+    // Exactly contactDistance apart counts as not touching
+    CHECK(!sweptContactTime({0.0f, 0.0f}, {0.0f, 0.0f}, {4.0f, 0.0f}, {4.0f, 0.0f}, 4.0f));
+}
+
+static void testCatchingUp() {
+    // Same direction, closing two pixels a tick on a gap of six: touching only
+    // as the tick ends, which is left for the next one
+    CHECK(!sweptContactTime({0.0f, 0.0f}, {3.0f, 0.0f}, {6.0f, 0.0f}, {7.0f, 0.0f}, 4.0f));
+
+    // Closing three pixels a tick instead
+    CHECK(near(sweptContactTime({0.0f, 0.0f}, {4.0f, 0.0f}, {6.0f, 0.0f}, {7.0f, 0.0f}, 4.0f), 2.0f / 3.0f));
+}
+
+static void testPerpendicularPaths() {
+    // One moving right along a row, one moving up a column through the same tile
+    std::optional<float> time = sweptContactTime({0.0f, 10.0f}, {10.0f, 10.0f}, {10.0f, 20.0f}, {10.0f, 10.0f}, 4.0f);
+    CHECK(near(time, 0.6f));
+
+    // The symmetric call gives the same time
+    CHECK(near(sweptContactTime({10.0f, 20.0f}, {10.0f, 10.0f}, {0.0f, 10.0f}, {10.0f, 10.0f}, 4.0f), 0.6f));
+}
+
+int main() {
+    testHeadOnPassThrough();
+    testAlreadyTouching();
+    testNeverTouching();
+    testCatchingUp();
+    testPerpendicularPaths();
+    return checkResult();
+}